@@ -0,0 +1,216 @@
+/// Measures the cost of looking up glyphs in the glyph cache:
+///		- GlyphCache: open addressing hash table, what ShaperManager uses
+///		- std::map: keyed by codepoint, ptSize & font, which is what Colibri used to do
+///
+/// Keys are synthetic (a few scripts, sizes & fonts); no font or render system is needed.
+/// Lookups follow a skewed distribution, like the glyphs of real text do.
+/// Usage: Benchmark_GlyphCache [numGlyphs] [numLookups]
+
+#include "ColibriGui/Text/ColibriGlyphCache.h"
+#include "ColibriGui/Text/ColibriShaperManager.h"
+
+#include <chrono>
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace Colibri;
+
+/// Same key & ordering ShaperManager used with std::map
+struct GlyphKey
+{
+	uint32_t codepoint;
+	uint32_t ptSize;
+	uint32_t fontIdx;
+
+	bool operator<( const GlyphKey &other ) const
+	{
+		if( this->codepoint != other.codepoint )
+			return this->codepoint < other.codepoint;
+		if( this->ptSize != other.ptSize )
+			return this->ptSize < other.ptSize;
+		return this->fontIdx < other.fontIdx;
+	}
+};
+
+typedef std::map<GlyphKey, CachedGlyph> CachedGlyphMap;
+typedef std::vector<GlyphKey> GlyphKeyVec;
+typedef std::chrono::steady_clock Clock;
+
+/// Codepoint ranges the synthetic glyphs are taken from: Latin, Greek, Cyrillic & CJK
+static const uint32_t c_scriptStarts[4] = { 0x0020u, 0x0391u, 0x0410u, 0x4E00u };
+static const uint32_t c_scriptSizes[4] = { 95u, 57u, 64u, 20000u };
+static const uint32_t c_ptSizes[3] = { 12u << 6u, 16u << 6u, 24u << 6u };
+static const uint32_t c_numFonts = 2u;
+//-------------------------------------------------------------------------
+/// Deterministic, so runs can be compared against each other
+static uint32_t randomU32( uint32_t &seed )
+{
+	seed = seed * 1664525u + 1013904223u;
+	return seed >> 8u;
+}
+//-------------------------------------------------------------------------
+static void generateKeys( GlyphKeyVec &outKeys, size_t numGlyphs )
+{
+	uint32_t seed = 12345u;
+	std::map<GlyphKey, bool> used;
+
+	outKeys.clear();
+	outKeys.reserve( numGlyphs );
+
+	while( outKeys.size() < numGlyphs )
+	{
+		const uint32_t script = randomU32( seed ) % 4u;
+		GlyphKey key;
+		key.codepoint = c_scriptStarts[script] + randomU32( seed ) % c_scriptSizes[script];
+		key.ptSize = c_ptSizes[randomU32( seed ) % 3u];
+		key.fontIdx = 1u + randomU32( seed ) % c_numFonts;
+
+		if( used.insert( std::pair<GlyphKey, bool>( key, true ) ).second )
+			outKeys.push_back( key );
+	}
+}
+//-------------------------------------------------------------------------
+/// Most lookups hit a few glyphs (e.g. 'e', ' '), a few hit the rest.
+/// Roughly 10% of the lookups are for glyphs that aren't cached.
+static void generateLookups( GlyphKeyVec &outLookups, const GlyphKeyVec &keys, size_t numLookups )
+{
+	uint32_t seed = 54321u;
+	const uint32_t numKeys = static_cast<uint32_t>( keys.size() );
+
+	outLookups.resize( numLookups );
+
+	GlyphKeyVec::iterator itor = outLookups.begin();
+	GlyphKeyVec::iterator endt = outLookups.end();
+
+	while( itor != endt )
+	{
+		const uint32_t r = randomU32( seed );
+		if( r % 10u == 0u )
+		{
+			// Private use area. Never inserted
+			itor->codepoint = 0xE000u + r % 0x1000u;
+			itor->ptSize = c_ptSizes[0];
+			itor->fontIdx = 1u;
+		}
+		else
+		{
+			// Squaring a uniform value skews it towards the first keys
+			const uint64_t u = randomU32( seed ) % numKeys;
+			*itor = keys[static_cast<size_t>( ( u * u ) / numKeys )];
+		}
+		++itor;
+	}
+}
+//-------------------------------------------------------------------------
+static CachedGlyph makeGlyph( const GlyphKey &key )
+{
+	CachedGlyph glyph;
+	memset( &glyph, 0, sizeof( glyph ) );
+	glyph.codepoint = key.codepoint;
+	glyph.ptSize = key.ptSize;
+	glyph.font = static_cast<uint16_t>( key.fontIdx );
+	glyph.width = 8u;
+	glyph.height = 12u;
+	return glyph;
+}
+//-------------------------------------------------------------------------
+static double elapsedNsSince( const Clock::time_point start, size_t numOperations )
+{
+	const double elapsedNs = static_cast<double>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>( Clock::now() - start ).count() );
+	return elapsedNs / static_cast<double>( numOperations );
+}
+//-------------------------------------------------------------------------
+/// Sums the widths of the glyphs found, so the compiler can't skip the lookups
+/// and both containers can be checked to agree.
+static size_t findAll( const GlyphCache &cache, const GlyphKeyVec &lookups )
+{
+	size_t retVal = 0u;
+
+	GlyphKeyVec::const_iterator itor = lookups.begin();
+	GlyphKeyVec::const_iterator endt = lookups.end();
+
+	while( itor != endt )
+	{
+		const CachedGlyph *glyph = cache.find( itor->codepoint, itor->ptSize, itor->fontIdx );
+		if( glyph )
+			retVal += glyph->width;
+		++itor;
+	}
+
+	return retVal;
+}
+//-------------------------------------------------------------------------
+static size_t findAll( const CachedGlyphMap &cache, const GlyphKeyVec &lookups )
+{
+	size_t retVal = 0u;
+
+	GlyphKeyVec::const_iterator itor = lookups.begin();
+	GlyphKeyVec::const_iterator endt = lookups.end();
+
+	while( itor != endt )
+	{
+		CachedGlyphMap::const_iterator glyphIt = cache.find( *itor );
+		if( glyphIt != cache.end() )
+			retVal += glyphIt->second.width;
+		++itor;
+	}
+
+	return retVal;
+}
+//-----------------------------------------------------------------------------
+int main( int argc, char *argv[] )
+{
+	const size_t numGlyphs = argc > 1 ? strtoul( argv[1], 0, 10 ) : 4096u;
+	const size_t numLookups = argc > 2 ? strtoul( argv[2], 0, 10 ) : 4000000u;
+
+	if( numGlyphs == 0u || numGlyphs > 100000u || numLookups == 0u )
+	{
+		printf( "Usage: %s [numGlyphs (max 100000)] [numLookups]\n", argv[0] );
+		return 1;
+	}
+
+	GlyphKeyVec keys;
+	generateKeys( keys, numGlyphs );
+
+	GlyphKeyVec lookups;
+	generateLookups( lookups, keys, numLookups );
+
+	GlyphCache glyphCache;
+	CachedGlyphMap glyphMap;
+
+	Clock::time_point start = Clock::now();
+	for( size_t i = 0u; i < numGlyphs; ++i )
+		glyphCache.insert( makeGlyph( keys[i] ) );
+	const double cacheInsertNs = elapsedNsSince( start, numGlyphs );
+
+	start = Clock::now();
+	for( size_t i = 0u; i < numGlyphs; ++i )
+		glyphMap.insert( CachedGlyphMap::value_type( keys[i], makeGlyph( keys[i] ) ) );
+	const double mapInsertNs = elapsedNsSince( start, numGlyphs );
+
+	start = Clock::now();
+	const size_t cacheResult = findAll( glyphCache, lookups );
+	const double cacheFindNs = elapsedNsSince( start, numLookups );
+
+	start = Clock::now();
+	const size_t mapResult = findAll( glyphMap, lookups );
+	const double mapFindNs = elapsedNsSince( start, numLookups );
+
+	if( cacheResult != mapResult || glyphCache.size() != glyphMap.size() )
+	{
+		printf( "Mismatch: GlyphCache found %u, std::map found %u\n", unsigned( cacheResult ),
+				unsigned( mapResult ) );
+		return 1;
+	}
+
+	printf( "%u glyphs, %u lookups\n", unsigned( numGlyphs ), unsigned( numLookups ) );
+	printf( "GlyphCache: insert %8.2f ns, find %8.2f ns\n", cacheInsertNs, cacheFindNs );
+	printf( "std::map:   insert %8.2f ns, find %8.2f ns\n", mapInsertNs, mapFindNs );
+	printf( "Find speedup: %.2fx\n", mapFindNs / cacheFindNs );
+
+	return 0;
+}
@@ -0,0 +1,244 @@
+/// Measures the per-widget cost of generating the vertices of a 9-slice:
+///		- Renderable::addNineSlice: 16 vertices, using SSE2 / NEON when available
+///		- 9 x Renderable::addQuad: 54 vertices, which is what Colibri used to do
+///
+/// The widgets are synthetic; no window or render system is needed.
+/// Usage: Benchmark_NineSlice [numWidgets] [numIterations]
+
+#include "ColibriRenderable.inl"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace Colibri;
+
+/// Exposes Renderable's vertex generation. Never instantiated
+class NineSliceBenchmark : public Renderable
+{
+public:
+	using Renderable::addNineSlice;
+	using Renderable::addQuad;
+};
+
+struct SyntheticWidget
+{
+	float gridX[4];
+	float gridY[4];
+	Ogre::Vector4 uvTopLeftBottomRight[GridLocations::NumGridLocations];
+	Ogre::Vector2 parentDerivedTL;
+	Ogre::Vector2 parentDerivedBR;
+	Ogre::Vector2 invSize;
+	Matrix2x3 derivedRot;
+	uint8_t rgbaColour[4];
+};
+
+typedef std::vector<SyntheticWidget> SyntheticWidgetVec;
+typedef std::vector<UiVertex> UiVertexVec;
+typedef std::chrono::steady_clock Clock;
+typedef void ( *FillFunc )( const SyntheticWidgetVec &widgets, UiVertex *vertexBuffer );
+
+static const float c_canvasAspectRatio = 1920.0f / 1080.0f;
+static const float c_invCanvasAspectRatio = 1080.0f / 1920.0f;
+static const uint32_t c_numQuadVertices = 6u;
+//-------------------------------------------------------------------------
+/// Deterministic, so runs can be compared against each other
+static float randomUnit( uint32_t &seed )
+{
+	seed = seed * 1664525u + 1013904223u;
+	return static_cast<float>( seed >> 8u ) / static_cast<float>( 1u << 24u );
+}
+//-------------------------------------------------------------------------
+static void generateWidgets( SyntheticWidgetVec &outWidgets, size_t numWidgets )
+{
+	uint32_t seed = 12345u;
+	const Ogre::Vector2 pixelSize2x( 2.0f / 1920.0f, 2.0f / 1080.0f );
+
+	outWidgets.resize( numWidgets );
+
+	SyntheticWidgetVec::iterator itor = outWidgets.begin();
+	SyntheticWidgetVec::iterator endt = outWidgets.end();
+
+	while( itor != endt )
+	{
+		SyntheticWidget &widget = *itor;
+
+		const Ogre::Vector2 outerTopLeft( randomUnit( seed ) * 1.5f - 1.0f,
+										  randomUnit( seed ) * 1.5f - 1.0f );
+		const Ogre::Vector2 size( 0.05f + randomUnit( seed ) * 0.4f,
+								  0.05f + randomUnit( seed ) * 0.4f );
+		const Ogre::Vector2 border = pixelSize2x * ( 2.0f + randomUnit( seed ) * 14.0f );
+
+		widget.gridX[0] = outerTopLeft.x;
+		widget.gridX[1] = outerTopLeft.x + border.x;
+		widget.gridX[2] = outerTopLeft.x + size.x - border.x;
+		widget.gridX[3] = outerTopLeft.x + size.x;
+		widget.gridY[0] = outerTopLeft.y;
+		widget.gridY[1] = outerTopLeft.y + border.y;
+		widget.gridY[2] = outerTopLeft.y + size.y - border.y;
+		widget.gridY[3] = outerTopLeft.y + size.y;
+
+		// Adjacent cells share their UVs, like SkinManager generates them
+		const float uvBorder = 8.0f / 1024.0f;
+		const float u[4] = { 0.25f, 0.25f + uvBorder, 0.5f - uvBorder, 0.5f };
+		const float v[4] = { 0.5f, 0.5f + uvBorder, 0.75f - uvBorder, 0.75f };
+		for( size_t row = 0u; row < 3u; ++row )
+		{
+			for( size_t col = 0u; col < 3u; ++col )
+			{
+				widget.uvTopLeftBottomRight[row * 3u + col] =
+					Ogre::Vector4( u[col], v[row], u[col + 1u], v[row + 1u] );
+			}
+		}
+
+		widget.parentDerivedTL = outerTopLeft;
+		widget.parentDerivedBR = outerTopLeft + size;
+		widget.invSize = 1.0f / size;
+
+		// The vertex math doesn't special-case identity, thus the angle doesn't affect timings
+		const float angle = randomUnit( seed ) * 0.5f;
+		widget.derivedRot = Matrix2x3( cosf( angle ), -sinf( angle ), 0.0f,  //
+									   sinf( angle ), cosf( angle ), 0.0f );
+
+		widget.rgbaColour[0] = 255u;
+		widget.rgbaColour[1] = 128u;
+		widget.rgbaColour[2] = 64u;
+		widget.rgbaColour[3] = 255u;
+
+		++itor;
+	}
+}
+//-------------------------------------------------------------------------
+static void fillNineSlices( const SyntheticWidgetVec &widgets, UiVertex *vertexBuffer )
+{
+	SyntheticWidgetVec::const_iterator itor = widgets.begin();
+	SyntheticWidgetVec::const_iterator endt = widgets.end();
+
+	while( itor != endt )
+	{
+		const SyntheticWidget &widget = *itor;
+		NineSliceBenchmark::addNineSlice(
+			vertexBuffer, widget.gridX, widget.gridY, widget.uvTopLeftBottomRight,
+			widget.rgbaColour, widget.parentDerivedTL, widget.parentDerivedBR, widget.invSize,
+			c_canvasAspectRatio, c_invCanvasAspectRatio, widget.derivedRot );
+		vertexBuffer += c_numNineSliceVertices;
+		++itor;
+	}
+}
+//-------------------------------------------------------------------------
+static void fillQuads( const SyntheticWidgetVec &widgets, UiVertex *vertexBuffer )
+{
+	SyntheticWidgetVec::const_iterator itor = widgets.begin();
+	SyntheticWidgetVec::const_iterator endt = widgets.end();
+
+	while( itor != endt )
+	{
+		const SyntheticWidget &widget = *itor;
+
+		uint8_t rgbaColour[4];
+		memcpy( rgbaColour, widget.rgbaColour, sizeof( rgbaColour ) );
+
+		for( size_t row = 0u; row < 3u; ++row )
+		{
+			for( size_t col = 0u; col < 3u; ++col )
+			{
+				NineSliceBenchmark::addQuad(
+					vertexBuffer, Ogre::Vector2( widget.gridX[col], widget.gridY[row] ),
+					Ogre::Vector2( widget.gridX[col + 1u], widget.gridY[row + 1u] ),
+					widget.uvTopLeftBottomRight[row * 3u + col], rgbaColour,
+					widget.parentDerivedTL, widget.parentDerivedBR, widget.invSize,
+					c_canvasAspectRatio, c_invCanvasAspectRatio, widget.derivedRot );
+				vertexBuffer += c_numQuadVertices;
+			}
+		}
+		++itor;
+	}
+}
+//-------------------------------------------------------------------------
+/// Returns the average time per widget, in nanoseconds
+static double measure( FillFunc fillFunc, const SyntheticWidgetVec &widgets,
+					   UiVertexVec &vertices, size_t numIterations )
+{
+	// Warm up caches & page in the buffer
+	fillFunc( widgets, &vertices[0] );
+
+	const Clock::time_point start = Clock::now();
+	for( size_t i = 0u; i < numIterations; ++i )
+		fillFunc( widgets, &vertices[0] );
+	const Clock::time_point end = Clock::now();
+
+	const double elapsedNs = static_cast<double>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>( end - start ).count() );
+	return elapsedNs / static_cast<double>( numIterations * widgets.size() );
+}
+//-------------------------------------------------------------------------
+/// Both paths must produce the same corners. Each quad starts with its top left corner.
+static bool validate( const SyntheticWidgetVec &widgets, const UiVertexVec &nineSliceVertices,
+					  const UiVertexVec &quadVertices )
+{
+	for( size_t widgetIdx = 0u; widgetIdx < widgets.size(); ++widgetIdx )
+	{
+		const UiVertex *nineSlice = &nineSliceVertices[widgetIdx * c_numNineSliceVertices];
+		const UiVertex *quads = &quadVertices[widgetIdx * 9u * c_numQuadVertices];
+
+		for( size_t row = 0u; row < 3u; ++row )
+		{
+			for( size_t col = 0u; col < 3u; ++col )
+			{
+				const UiVertex &corner = nineSlice[row * 4u + col];
+				const UiVertex &quadTopLeft = quads[( row * 3u + col ) * c_numQuadVertices];
+				if( memcmp( &corner, &quadTopLeft, sizeof( UiVertex ) ) != 0 )
+				{
+					printf( "Mismatch in widget %u, cell %u\n", unsigned( widgetIdx ),
+							unsigned( row * 3u + col ) );
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+//-----------------------------------------------------------------------------
+int main( int argc, char *argv[] )
+{
+	const size_t numWidgets = argc > 1 ? strtoul( argv[1], 0, 10 ) : 1024u;
+	const size_t numIterations = argc > 2 ? strtoul( argv[2], 0, 10 ) : 2000u;
+
+	if( numWidgets == 0u || numIterations == 0u )
+	{
+		printf( "Usage: %s [numWidgets] [numIterations]\n", argv[0] );
+		return 1;
+	}
+
+	SyntheticWidgetVec widgets;
+	generateWidgets( widgets, numWidgets );
+
+	UiVertexVec nineSliceVertices( numWidgets * c_numNineSliceVertices );
+	UiVertexVec quadVertices( numWidgets * 9u * c_numQuadVertices );
+
+	const double quadNs = measure( fillQuads, widgets, quadVertices, numIterations );
+	const double nineSliceNs = measure( fillNineSlices, widgets, nineSliceVertices, numIterations );
+
+	if( !validate( widgets, nineSliceVertices, quadVertices ) )
+		return 1;
+
+#if COLIBRI_SIMD_SSE2
+	const char *simdName = "SSE2";
+#elif COLIBRI_SIMD_NEON
+	const char *simdName = "NEON";
+#else
+	const char *simdName = "none";
+#endif
+
+	printf( "%u widgets x %u iterations. SIMD: %s. COLIBRI_COMPACT_VERTICES: %i\n",
+			unsigned( numWidgets ), unsigned( numIterations ), simdName, COLIBRI_COMPACT_VERTICES );
+	printf( "9 x addQuad:  %8.2f ns/widget (%u vertices, %u bytes)\n", quadNs,
+			9u * c_numQuadVertices, unsigned( 9u * c_numQuadVertices * sizeof( UiVertex ) ) );
+	printf( "addNineSlice: %8.2f ns/widget (%u vertices, %u bytes)\n", nineSliceNs,
+			c_numNineSliceVertices, unsigned( c_numNineSliceVertices * sizeof( UiVertex ) ) );
+	printf( "Speedup: %.2fx\n", quadNs / nineSliceNs );
+
+	return 0;
+}
@@ -9,7 +9,7 @@
 
 	@property( colibri_text )
 		vulkan_layout( OGRE_TANGENT ) in uint tangent;
-		vulkan_layout( OGRE_BLENDINDICES ) in uint2 blendIndices;
+		vulkan_layout( OGRE_BLENDINDICES ) in uint4 blendIndices;
 	@end
 @end
 
@@ -17,28 +17,54 @@
 	@property( !colibri_text )
 		uint colibriDrawId = inVs_drawId
 		@property( !colibri_custom_shape )
-				+ ((uint(inVs_vertexId) - worldMaterialIdx[inVs_drawId].w) / 54u)
+				+ ((uint(inVs_vertexId) - worldMaterialIdx[inVs_drawId].w) / 16u) * 3u
 		@end
 				;
 		#undef finalDrawId
 		#define finalDrawId colibriDrawId
+	@else
+		// Labels chained in the same draw are told apart by the slot in their vertices,
+		// relative to the first Label's. See Colibri::Renderable::m_textDrawSlot
+		uint colibriDrawId = inVs_drawId +
+				((blendIndices.z - (worldMaterialIdx[inVs_drawId].w >> 2u)) & 0xFFFFu) * 3u;
+		#undef finalDrawId
+		#define finalDrawId colibriDrawId
 	@end
 
 	#define worldViewProj 1.0f
 
+	// Colibri::DrawParams, written by HlmsColibri::fillBuffersForColibri
+	float4 colibriPosOffsetClipScale = uintBitsToFloat( worldMaterialIdx[colibriDrawId + 1u] );
+	float4 colibriClipBias = uintBitsToFloat( worldMaterialIdx[colibriDrawId + 2u] );
+
+	float4 colibriVertex = float4( inVs_vertex.xy + colibriPosOffsetClipScale.xy, inVs_vertex.zw );
+	#undef inVs_vertex
+	#define inVs_vertex colibriVertex
+
+	float4 colibriClipDistance = normal * colibriPosOffsetClipScale.wzzw + colibriClipBias;
+
 	@property( hlms_pso_clip_distances >= 4 )
-		gl_ClipDistance[0] = normal.x;
-		gl_ClipDistance[1] = normal.y;
-		gl_ClipDistance[2] = normal.z;
-		gl_ClipDistance[3] = normal.w;
+		gl_ClipDistance[0] = colibriClipDistance.x;
+		gl_ClipDistance[1] = colibriClipDistance.y;
+		gl_ClipDistance[2] = colibriClipDistance.z;
+		gl_ClipDistance[3] = colibriClipDistance.w;
 	@else
-		outVs.emulatedClipDistance = normal;
+		outVs.emulatedClipDistance = colibriClipDistance;
+	@end
+
+	@property( colibri_graph )
+		// Colibri::GraphChart's per-draw constants. Read by the pixel shader
+		outVs.graphArea = uintBitsToFloat( worldMaterialIdx[colibriDrawId + 3u] );
+		outVs.graphIntervals = uintBitsToFloat( worldMaterialIdx[colibriDrawId + 4u] );
+		outVs.graphColours = worldMaterialIdx[colibriDrawId + 5u];
+		@foreach( colibri_numDatasetVec4s, n )
+			outVs.graphDatasetCols@n = worldMaterialIdx[colibriDrawId + 6u + uint( @n )];@end
 	@end
 
 	@property( colibri_text )
-		uint vertId = (uint(inVs_vertexId) - worldMaterialIdx[inVs_drawId].w) % 6u;
-		outVs.uvText.x = (vertId <= 1u || vertId == 5u) ? 0.0f : float( blendIndices.x );
-		outVs.uvText.y = (vertId == 0u || vertId >= 4u) ? 0.0f : float( blendIndices.y );
+		uint vertId = (uint(inVs_vertexId) - worldMaterialIdx[inVs_drawId].w) % 4u;
+		outVs.uvText.x = (vertId <= 1u) ? 0.0f : float( blendIndices.x );
+		outVs.uvText.y = (vertId == 0u || vertId == 3u) ? 0.0f : float( blendIndices.y );
 		outVs.pixelsPerRow		= blendIndices.x;
 		outVs.glyphOffsetStart	= tangent;
 	@end
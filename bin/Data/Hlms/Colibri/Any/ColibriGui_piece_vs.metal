@@ -5,7 +5,7 @@
 
 	@property( colibri_text )
 		uint tangent [[attribute(VES_TANGENT)]];
-		uint2 blendIndices [[attribute(VES_BLEND_INDICES)]];
+		uint4 blendIndices [[attribute(VES_BLEND_INDICES)]];
 	@end
 @end
 
@@ -17,24 +17,48 @@
 	@property( !colibri_text )
 		uint colibriDrawId = inVs_drawId
 		@property( !colibri_custom_shape )
-			+ ((uint(inVs_vertexId) - worldMaterialIdx[inVs_drawId].w) / 54u)
+			+ ((uint(inVs_vertexId) - worldMaterialIdx[inVs_drawId].w) / 16u) * 3u
 		@end
 			;
 		#undef finalDrawId
 		#define finalDrawId colibriDrawId
+	@else
+		// Labels chained in the same draw are told apart by the slot in their vertices,
+		// relative to the first Label's. See Colibri::Renderable::m_textDrawSlot
+		uint colibriDrawId = inVs_drawId +
+				((input.blendIndices.z - (worldMaterialIdx[inVs_drawId].w >> 2u)) & 0xFFFFu) * 3u;
+		#undef finalDrawId
+		#define finalDrawId colibriDrawId
 	@end
 
 	#define worldViewProj 1.0f
 
-	outVs.gl_ClipDistance[0] = input.normal.x;
-	outVs.gl_ClipDistance[1] = input.normal.y;
-	outVs.gl_ClipDistance[2] = input.normal.z;
-	outVs.gl_ClipDistance[3] = input.normal.w;
+	// Colibri::DrawParams, written by HlmsColibri::fillBuffersForColibri
+	float4 colibriPosOffsetClipScale = as_type<float4>( worldMaterialIdx[colibriDrawId + 1u] );
+	float4 colibriClipBias = as_type<float4>( worldMaterialIdx[colibriDrawId + 2u] );
+
+	input.vertex.xy += colibriPosOffsetClipScale.xy;
+
+	float4 colibriClipDistance = input.normal * colibriPosOffsetClipScale.wzzw + colibriClipBias;
+
+	outVs.gl_ClipDistance[0] = colibriClipDistance.x;
+	outVs.gl_ClipDistance[1] = colibriClipDistance.y;
+	outVs.gl_ClipDistance[2] = colibriClipDistance.z;
+	outVs.gl_ClipDistance[3] = colibriClipDistance.w;
+
+	@property( colibri_graph )
+		// Colibri::GraphChart's per-draw constants. Read by the pixel shader
+		outVs.graphArea = as_type<float4>( worldMaterialIdx[colibriDrawId + 3u] );
+		outVs.graphIntervals = as_type<float4>( worldMaterialIdx[colibriDrawId + 4u] );
+		outVs.graphColours = worldMaterialIdx[colibriDrawId + 5u];
+		@foreach( colibri_numDatasetVec4s, n )
+			outVs.graphDatasetCols@n = worldMaterialIdx[colibriDrawId + 6u + uint( @n )];@end
+	@end
 
 	@property( colibri_text )
-		uint vertId = (uint(inVs_vertexId) - worldMaterialIdx[inVs_drawId].w) % 6u;
-		outVs.uvText.x = (vertId <= 1u || vertId == 5u) ? 0.0f : float( input.blendIndices.x );
-		outVs.uvText.y = (vertId == 0u || vertId >= 4u) ? 0.0f : float( input.blendIndices.y );
+		uint vertId = (uint(inVs_vertexId) - worldMaterialIdx[inVs_drawId].w) % 4u;
+		outVs.uvText.x = (vertId <= 1u) ? 0.0f : float( input.blendIndices.x );
+		outVs.uvText.y = (vertId == 0u || vertId == 3u) ? 0.0f : float( input.blendIndices.y );
 		outVs.pixelsPerRow		= input.blendIndices.x;
 		outVs.glyphOffsetStart	= input.tangent;
 	@end
@@ -127,6 +127,9 @@ namespace Colibri
 		/// See getNumVertices()
 		UiVertex *getVertices() { return m_vertices.begin(); }
 
+		void _getVertexCountUpperBound( size_t &inOutNumVertices,
+										size_t &inOutNumTextVertices ) const override;
+
 		void _fillBuffersAndCommands(
 			UiVertex *colibri_nonnull *colibri_nonnull RESTRICT_ALIAS    vertexBuffer,
 			GlyphVertex *colibri_nonnull *colibri_nonnull RESTRICT_ALIAS textVertBuffer,
@@ -3,6 +3,8 @@
 
 #include "ColibriGui/ColibriCustomShape.h"
 
+#include <deque>
+
 COLIBRI_ASSUME_NONNULL_BEGIN
 
 namespace Colibri
@@ -14,10 +16,19 @@ namespace Colibri
 	class GraphChart : public CustomShape
 	{
 	public:
+		/// Each group of 4 datasets takes one interpolant to send its colours to
+		/// the pixel shader, and interpolants are scarce (e.g. 16 vec4 on GLES 3).
+		/// Charts with more datasets bake their colours into the shader instead,
+		/// which means one shader per chart, rebuilt on every call to build().
+		static const uint32_t c_maxDatasets = 16u;
+
 		struct Column
 		{
 			/// Value for this data entry is in range (-inf; inf).
 			/// See setDataRange().
+			///
+			/// After using pushSamples() this is a ring buffer: the oldest
+			/// sample is at getWriteCursor().
 			float *values;
 
 			Colibri::Label *label;
@@ -45,9 +56,26 @@ namespace Colibri
 		};
 
 	protected:
+		struct WindowSample
+		{
+			uint64_t sampleIdx;
+			float    value;
+		};
+
 		std::vector<Column> m_columns;
 		std::vector<float>  m_allValues;
 
+		/// Where pushSamples() will write next. Also the oldest sample.
+		uint32_t m_writeCursor;
+		/// Total number of samples (per column) ever pushed. See m_windowMin
+		uint64_t m_numPushedSamples;
+
+		/// Monotonic queues with the min & max of the samples in the last
+		/// getEntriesPerColumn() pushes, so that the auto min/max doesn't need to
+		/// rescan all the samples. The front holds the min (or max) of the window.
+		std::deque<WindowSample> m_windowMin;
+		std::deque<WindowSample> m_windowMax;
+
 		Ogre::TextureGpu *m_textureData;
 
 		bool m_labelsDirty;
@@ -68,6 +96,36 @@ namespace Colibri
 
 		Params m_params;
 
+		/// Per-draw constants read by the shader. See fillGraphDrawParams
+		std::vector<uint32_t> m_graphDrawParams;
+		/// Value of colibri_numDatasets our shader was built with
+		uint32_t m_numDatasetsBucket;
+
+		/** Fills m_graphDrawParams from m_params & the columns' colours. Layout (in uint4):
+				[0] float4( graphStartTL.xy, graphEndBR.xy )
+				[1] float4( intervalLength, intervalBlankAreaSize, numDatasets, ringOffset )
+				[2] uint4( lineColour, bgInnerColour, bgOuterColour, 0 )
+				[3...] uint4 with the colour of 4 datasets each. Absent above c_maxDatasets
+			Colours are packed as RGBA8 (R in the lowest byte).
+		*/
+		void fillGraphDrawParams();
+
+		/// Updates the ring offset in m_graphDrawParams, so that the shader starts
+		/// reading at m_writeCursor.
+		void updateRingOffset();
+
+		/// Adds a sample (the min & max of all columns at the same entry) to m_windowMin & m_windowMax
+		void pushToWindow( float minValue, float maxValue );
+		/// Rebuilds m_windowMin & m_windowMax from scratch, from all the current values
+		void rebuildWindow();
+
+		/// Returns the range of values to display, based on the window & setDataRange settings.
+		void calculateDataRange( float &outMinSample, float &outMaxSample ) const;
+
+		/// Uploads the entries in range [firstEntry; firstEntry + numEntries) of all columns
+		void uploadEntries( uint32_t firstEntry, uint32_t numEntries, float minSample,
+							float maxSample );
+
 		void positionGraphLegend();
 		void positionMarkersInLines( const float minValue, const float maxValue );
 		void positionLabels();
@@ -83,6 +141,7 @@ namespace Colibri
 			All previous data may be cleared!
 		@param numColumns
 			Number of columns to display.
+			Above c_maxDatasets the chart can't share its shader with other charts.
 		@param entriesPerColumn
 			Max number of elements per column.
 			Max. value is 2048.
@@ -166,7 +225,9 @@ namespace Colibri
 					setColour( true, Ogre::ColourValue( 0.0f, 1.0f, 0.0f, 0.85f ) );
 			@endcode
 		@remarks
-			Changing these settings can trigger a shader recompilation.
+			Params and colours are sent as per-draw constants, thus they never cause
+			a shader recompilation. The shader is only shared by charts whose number of
+			columns round up to the same multiple of 4.
 			You *can* call syncChart() after build().
 			<br/>
 			You *can* call this function again if you wish to change settings.
@@ -178,6 +239,27 @@ namespace Colibri
 		/// Every time you do that, you must call syncChart() again.
 		void syncChart();
 
+		/** Appends new samples to every column, overwriting the oldest ones (i.e. the chart
+			scrolls). Much cheaper than modifying Column::values and calling syncChart()
+			when adding a few samples per frame, since only the new samples are uploaded
+			to the GPU, and the auto min/max (see setDataRange) is kept up to date
+			incrementally.
+
+			Everything gets uploaded again though, if the displayed range of values changed.
+		@remarks
+			Must be called after build(). There is no need to call syncChart().
+		@param samples
+			Array of getColumns().size() * numSamples values.
+			Sample s of column c is at samples[s * getColumns().size() + c]
+		@param numSamples
+			Number of samples per column.
+		*/
+		void pushSamples( const float *samples, uint32_t numSamples = 1u );
+
+		/// Returns the index in Column::values where the next pushed sample will be written.
+		/// This is also the index of the oldest sample.
+		uint32_t getWriteCursor() const { return m_writeCursor; }
+
 		void setTransformDirty( uint32_t dirtyReason ) override;
 	};
 }  // namespace Colibri
@@ -29,6 +29,24 @@
 	#define colibri_virtual_l1
 #endif
 
+/// COLIBRI_SIMD_SSE2 / COLIBRI_SIMD_NEON are defined when the target supports them,
+/// unless COLIBRI_NO_SIMD is defined (see CMake option COLIBRIGUI_SIMD)
+#if !defined( COLIBRI_NO_SIMD )
+#	if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#		define COLIBRI_SIMD_SSE2 1
+#	elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+#		define COLIBRI_SIMD_NEON 1
+#	endif
+#endif
+
+/// See CMake option COLIBRIGUI_COMPACT_VERTICES
+///		0 = UiVertex & GlyphVertex use full precision
+///		1 = Clip distances are stored as half floats
+///		2 = Positions are also stored as half floats
+#if !defined( COLIBRI_COMPACT_VERTICES )
+#	define COLIBRI_COMPACT_VERTICES 0
+#endif
+
 #if __cplusplus >= 201402L
 #	define COLIBRI_DEPRECATED [[deprecated]]
 #	define COLIBRI_DEPRECATED_VER( x ) [[deprecated]]
@@ -67,12 +85,14 @@ namespace Colibri
 	class Checkbox;
 	class ColibriManager;
 	class Editbox;
+	class GlyphRasterizer;
 	class GraphChart;
 	class Label;
 	class LabelBmp;
 	class LayoutCell;
 	class LogListener;
 	class OffScreenCanvas;
+	class OffScreenCanvasScheduler;
 	class Progressbar;
 	class RadarChart;
 	class Renderable;
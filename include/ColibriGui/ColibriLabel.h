@@ -49,6 +49,9 @@ namespace Colibri
 #endif
 		/// For internal use. Set to true if any of RichText uses background, false otherwise.
 		bool m_usesBackground;
+		/// True if any of our glyphs may still be rasterizing in a worker thread.
+		/// See ShaperManager::setAsyncRasterization
+		bool m_glyphsPending;
 
 	public:
 		/// When true (default) text will be clipped against the widget's size.
@@ -77,7 +80,7 @@ namespace Colibri
 		/// parent this Label to a Renderable with a dark background skin instead.
 		///
 		/// PUBLIC VARIABLE. This variable can be altered directly.
-		/// Changes are reflected immediately.
+		/// Changes are reflected immediately (in retained mode, call setVisualsDirty()).
 		Ogre::Vector2 m_backgroundMargin;
 
 	protected:
@@ -157,6 +160,8 @@ namespace Colibri
 		float findLineMaxHeight( ShapedGlyphVec::const_iterator start,
 								 States::States state ) const;
 
+		/// Writes the c_numGlyphVertices of a glyph (TL, BL, BR, TR).
+		/// See ColibriOgreRenderable::createGlyphIndexBuffer
 		colibri_virtual_l1 inline void addQuad( GlyphVertex * RESTRICT_ALIAS vertexBuffer,
 							 Ogre::Vector2 topLeft,
 							 Ogre::Vector2 bottomRight,
@@ -293,6 +298,11 @@ namespace Colibri
 		*/
 		void _updateDirtyGlyphs();
 
+		/** Called by ColibriManager when glyphs that were being rasterized in worker
+			threads got their pixels. If we use any of them, we need to be redrawn.
+		*/
+		void _notifyGlyphsRasterized();
+
 		/** Returns the max number of glyphs needed to render
 		@return
 			It's not the sum of all states, but rather the maximum of all states,
@@ -468,12 +478,15 @@ namespace Colibri
 						TextVertAlignment::TextVertAlignment newVertPos=TextVertAlignment::Top,
 						States::States baseState=States::NumStates );
 
+		void _getVertexCountUpperBound( size_t &inOutNumVertices,
+										size_t &inOutNumTextVertices ) const override;
+
 		GlyphVertex* fillBackground( GlyphVertex * RESTRICT_ALIAS textVertBuffer,
 									 const Ogre::Vector2 halfWindowRes,
 									 const Ogre::Vector2 invWindowRes,
 									 const Ogre::Vector2 parentDerivedTL,
 									 const Ogre::Vector2 parentDerivedBR,
-									 const bool isHorizontal );
+									 const bool isHorizontal, const uint32_t maxVertices );
 
 		void _fillBuffersAndCommands(
 			UiVertex *colibri_nonnull *colibri_nonnull RESTRICT_ALIAS vertexBuffer,
@@ -152,6 +152,9 @@ namespace Colibri
 		/// Recalculates the size of the widget based on the text contents to fit tightly.
 		void sizeToFit();
 
+		void _getVertexCountUpperBound( size_t &inOutNumVertices,
+										size_t &inOutNumTextVertices ) const override;
+
 		void _fillBuffersAndCommands(
 			UiVertex *colibri_nonnull *colibri_nonnull RESTRICT_ALIAS vertexBuffer,
 			GlyphVertex *colibri_nonnull *colibri_nonnull RESTRICT_ALIAS textVertBuffer,
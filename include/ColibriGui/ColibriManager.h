@@ -5,12 +5,15 @@
 
 #include "OgreIdString.h"
 
+#include <atomic>
+
 COLIBRI_ASSUME_NONNULL_BEGIN
 
 namespace Colibri
 {
 	typedef std::vector<Label*> LabelVec;
 	typedef std::vector<LabelBmp*> LabelBmpVec;
+	typedef std::vector<Renderable*> RenderableVec;
 
 	/**
 	@class LogListener
@@ -117,6 +120,47 @@ namespace Colibri
 		virtual void flushEffectReaction( uint16_t /*effectReaction*/, uint16_t /*repeatCount*/ ) {}
 	};
 
+	/**
+	@class TaskDispatcher
+		Allows ColibriGui to run work in parallel using your own job system.
+		See ColibriManager::setTaskDispatcher.
+
+		The default implementation runs all tasks serially in the calling thread.
+	*/
+	class TaskDispatcher
+	{
+	public:
+		typedef void ( *TaskFunc )( void *colibri_nullable userData, size_t taskIdx );
+
+		virtual ~TaskDispatcher();
+
+		/** Executes task( userData, taskIdx ) for every taskIdx in range [0; numTasks)
+			and returns once all of them have finished.
+		@remarks
+			Tasks are independent of each other. They can be run in any order and from
+			any thread, but each taskIdx must be executed exactly once.
+		@param numTasks
+			Number of tasks to execute.
+		@param task
+			Function to execute.
+		@param userData
+			Must be passed as is to task.
+		*/
+		virtual void dispatch( size_t numTasks, TaskFunc task, void *colibri_nullable userData );
+	};
+
+	/// See ColibriManager::getVertexBufferStats
+	struct VertexBufferStats
+	{
+		/// Number of vertices currently needed by all widgets (upper bound).
+		uint32_t usedVertices;
+		/// Number of vertices the buffer can hold (per pass, see setMultipassRingSize).
+		uint32_t capacity;
+		/// Largest usedVertices seen since the buffers were created
+		/// or resetVertexBufferHighWaterMarks was called.
+		uint32_t highWaterMark;
+	};
+
 	namespace EffectReaction
 	{
 		enum EffectReaction
@@ -168,6 +212,50 @@ namespace Colibri
 
 		typedef std::vector<DelayedDestruction> DelayedDestructionVec;
 
+		/// Region of the vertex buffers assigned to each window in m_windows
+		/// when filling them in parallel. See setTaskDispatcher
+		struct WindowVertexSlice
+		{
+			size_t vertexStart;
+			size_t textVertexStart;
+			/// Written by the task that filled the window
+			size_t vertexEnd;
+			size_t textVertexEnd;
+		};
+
+		typedef std::vector<WindowVertexSlice> WindowVertexSliceVec;
+
+		/// See Widget::m_reorderDraws
+		struct ReorderedDraw
+		{
+			Renderable             *renderable;
+			Ogre::HlmsDatablock    *datablock;
+			/// WidgetRenderType, or WidgetRenderType::CustomShape + 1 for LabelBmp
+			uint8_t                 renderType;
+			/// True if rotated, or if it can draw outside its rect (Labels, LabelBmps &
+			/// CustomShapes). We can't reason about its rect, so it overlaps everything.
+			bool                    bUnbounded;
+			Ogre::Vector2           topLeft;
+			Ogre::Vector2           bottomRight;
+			/// Index to the next ReorderedDraw in the same ReorderBatch
+			size_t                  nextInBatch;
+
+			bool sameBatchAs( const ReorderedDraw &other ) const
+			{
+				return datablock == other.datablock && renderType == other.renderType;
+			}
+		};
+		struct ReorderBatch
+		{
+			/// Index to the first & last ReorderedDraw
+			size_t          firstDraw;
+			size_t          lastDraw;
+			bool            bUnbounded;
+			/// Union of the rects of all draws in this batch
+			Ogre::Vector2   topLeft;
+			Ogre::Vector2   bottomRight;
+		};
+
 	public:
 		static const std::string c_defaultTextDatablockNames[States::NumStates];
 
@@ -181,6 +269,8 @@ namespace Colibri
 		size_t   m_numTextGlyphs;     /// It's an upper bound. Current max number of glyphs may be lower
 		size_t   m_numTextGlyphsBmp;  /// It's an upper bound. Current max number of glyphs may be lower
 		size_t   m_numCustomShapesVertices;
+		/// Regular widgets using c_numNineSlicePerCellVertices. See Renderable::updateNineSliceLayout
+		size_t   m_numNineSlicesPerCell;
 		LabelVec m_dirtyLabels;
 		LabelBmpVec m_dirtyLabelBmps;
 		WidgetVec m_dirtyWidgets;
@@ -202,6 +292,12 @@ namespace Colibri
 		/// @see	Widget::m_breadthFirst
 		WidgetVec m_breadthFirst[6];
 
+		/// Scratch memory. For internal use. See Widget::m_reorderDraws
+		std::vector<ReorderedDraw> m_reorderedDraws;
+		std::vector<ReorderBatch>  m_reorderBatches;
+		/// Scratch memory. For internal use. See Widget::_isSubtreeOverlapFree
+		WidgetVec m_overlapTestScratch;
+
 	protected:
 		LogListener	*m_logListener;
 		ColibriListener	*m_colibriListener;
@@ -224,13 +320,88 @@ namespace Colibri
 		bool m_touchOnlyMode;
 
 		const bool m_multipass;
+		/// See setMultipassRingSize. 0 means the ring is disabled.
+		uint32_t m_multipassRingSize;
+		/// Number of times prepareRenderCommands was called in the current frame minus 1.
+		/// Selects the region of the ring we write to. Only used when m_multipassRingSize != 0
+		uint32_t m_multipassPassIdx;
+
+		/// See setRetainedVertexBuffers
+		bool m_retainedVertexBuffers;
+		/// When true, all widgets must write their vertices during the current fill pass.
+		bool m_rewriteAllVertices;
+		/// Incremented every time prepareRenderCommands is called.
+		uint32_t m_fillPassIdx;
+		/// Value of VaoManager::getFrameCount the last time prepareRenderCommands was called.
+		uint32_t m_lastFrameIdxFilled;
+		/// Number of vertices written in the last call to prepareRenderCommands.
+		/// Atomic because windows may be filled in parallel.
+		std::atomic<uint32_t> m_numVerticesRewritten;
+		std::atomic<uint32_t> m_numTextVerticesRewritten;
+
+		/// Number of draws in subtrees with Widget::m_reorderDraws during the last render,
+		/// before and after reordering them.
+		uint32_t m_numDrawsBeforeReorder;
+		uint32_t m_numDrawsAfterReorder;
+
+		/// See setAutoBreadthFirst
+		bool     m_autoBreadthFirst;
+		/// Number of widgets that were automatically rendered in breadth first in the last render
+		uint32_t m_numAutoBreadthFirst;
+
+		/// See setDrawListCaching
+		bool m_drawListCaching;
+		/// True when m_drawList no longer matches what a full traversal would draw.
+		/// Atomic because widgets may be culled in parallel.
+		std::atomic<bool> m_drawListDirty;
+		/// Renderables drawn by the last full traversal, in order.
+		std::vector<Renderable *> m_drawList;
+
+		/// See setDirtyRegionTracking
+		bool m_dirtyRegionTracking;
+		/// When true, the whole canvas must be redrawn regardless of m_dirtyRegionRenderables
+		bool m_dirtyRegionFull;
+		/// Renderables whose visuals changed since the last flushDirtyRegion. May have duplicates
+		RenderableVec m_dirtyRegionRenderables;
+
+		/// Number of widgets with Widget::m_derivedTransformStale set.
+		/// Atomic because widgets may be culled in parallel.
+		std::atomic<uint32_t> m_numStaleDerivedTransforms;
+		/// Incremented every time a derived transform becomes stale, or a widget gets a new
+		/// parent. See Widget::m_derivedTransformCheckedEpoch
+		std::atomic<uint32_t> m_staleDerivedTransformEpoch;
+
+		TaskDispatcher *colibri_nullable m_taskDispatcher;
+		WindowVertexSliceVec             m_windowVertexSlices;
 
 		Ogre::Root *colibri_nullable                m_root;
 		Ogre::VaoManager *colibri_nullable          m_vaoManager;
 		Ogre::ObjectMemoryManager *colibri_nullable m_objectMemoryManager;
 		Ogre::SceneManager *colibri_nullable        m_sceneManager;
 		Ogre::VertexArrayObject *colibri_nullable   m_vao;
+		/// Shared by all 9-slices. See ColibriOgreRenderable::createIndexBuffer
+		Ogre::IndexBufferPacked *colibri_nullable   m_nineSliceIndexBuffer;
 		Ogre::VertexArrayObject *colibri_nullable   m_textVao;
+		/// Shared by all glyphs. See ColibriOgreRenderable::createGlyphIndexBuffer
+		Ogre::IndexBufferPacked *colibri_nullable   m_glyphIndexBuffer;
+		/// Small Vaos with the same vertex format as m_vao & m_textVao. Widgets point to these
+		/// (Ogre needs them to know the vertex format) and never change. This lets us recreate
+		/// m_vao & m_textVao without having to walk every widget. Draws use m_vao & m_textVao.
+		Ogre::VertexArrayObject *colibri_nullable   m_vertexFormatVao;
+		Ogre::VertexArrayObject *colibri_nullable   m_textVertexFormatVao;
+		/// Number of fill passes left in which all widgets must rewrite their vertices
+		/// because the vertex buffers were recreated.
+		uint8_t                                     m_pendingFullRewrites;
+		/// Index [0] is for m_vao, [1] for m_textVao.
+		/// Minimum capacity requested via reserve. Trimming never goes below it.
+		uint32_t m_reservedVertices[2];
+		/// See VertexBufferStats
+		uint32_t m_requiredVertices[2];
+		uint32_t m_vertexHighWaterMark[2];
+		/// See setAutoTrimBuffers. 0 means disabled.
+		uint32_t m_autoTrimFrames;
+		/// Consecutive updates in which less than half of the capacity was being used.
+		uint32_t m_lowUsageFrames[2];
 		std::vector<Ogre::IndirectBufferPacked *>   m_indirectBuffer;
 		uint32_t                                    m_currIndirectBuffer;
 		uint32_t                                    m_lastFrameIdxUpdated;
@@ -282,6 +453,8 @@ namespace Colibri
 	protected:
 		SkinManager	*m_skinManager;
 		ShaperManager *m_shaperManager;
+		/// Last ShaperManager::getRasterizedGlyphsGeneration our Labels were notified of
+		uint32_t m_rasterizedGlyphsGeneration;
 
 		SkinInfo const * colibri_nullable
 				m_defaultSkins[SkinWidgetTypes::NumSkinWidgetTypes][States::NumStates];
@@ -290,7 +463,7 @@ namespace Colibri
 		UiVertex    *m_vertexBufferBase;
 		GlyphVertex *m_textVertexBufferBase;
 
-		/// Only used when m_multipass == true
+		/// Only used when m_multipass == true && m_multipassRingSize == 0
 		std::vector<uint8_t> m_multipassTmpBuffer;
 
 #if COLIBRIGUI_DEBUG >= COLIBRIGUI_DEBUG_MEDIUM
@@ -311,10 +484,48 @@ namespace Colibri
 		void _notifyNumGlyphsIsDirty();
 		void _notifyNumGlyphsBmpIsDirty();
 		void _updateDirtyLabels();
+		/// Called by update when ShaperManager copied glyphs rasterized by worker threads to
+		/// the atlas. Labels using them get redrawn. See ShaperManager::processRasterizedGlyphs
+		void _notifyGlyphsRasterized();
 
 	protected:
+		/// Creates a Vao (for widgets, or text if bText) that can hold vertexCount vertices
+		/// per pass. See setMultipassRingSize.
+		Ogre::VertexArrayObject *createVao( uint32_t vertexCount, bool bText );
+		/// Returns the number of vertices each pass can write into the given vertex buffer.
+		uint32_t getVerticesPerPass( const Ogre::VertexBufferPacked *vertexBuffer ) const;
+		/// Recreates m_vao (or m_textVao if bText) so it can hold
+		/// newVertexCount per pass. Its contents are lost.
+		void resizeVao( uint32_t newVertexCount, bool bText );
+		/// Recreates m_vao (or m_textVao if bText) with more capacity if it can't hold
+		/// requiredVertexCount per pass. Returns true if it was recreated.
+		bool growVaoIfNeeded( uint32_t requiredVertexCount, bool bText );
+		/// Recreates m_vao (or m_textVao if bText) with less capacity if it holds more than
+		/// what's currently required (and reserved).
+		void trimVao( bool bText );
+
 		void checkVertexBufferCapacity();
 
+		/** Calculates m_windowVertexSlices via a prefix sum of the vertex count upper bounds
+			of each window.
+		@return
+			False if the upper bounds don't fit in the current vertex buffers.
+		*/
+		bool calculateWindowVertexSlices();
+
+		/// Adds all non-culled Renderables from widget's subtree (excluding
+		/// Windows) to m_reorderedDraws, in painter's order.
+		void collectReorderedDraws( const Widget *widget );
+		/// Returns true if draw overlaps any of the draws in batch
+		bool overlapsBatch( const ReorderedDraw &draw, const ReorderBatch &batch ) const;
+
+		/// Fills the vertex buffers of m_windows[windowIdx] in its own slice.
+		void fillWindowBuffers( size_t windowIdx );
+		/// Returns true if a window wrote past the start of the next window's slice,
+		/// or the last window past the end of the vertex buffers
+		bool haveWindowVertexSlicesOverflowed() const;
+		static void fillWindowBuffersTask( void *colibri_nullable userData, size_t windowIdx );
+
 		UiVertex    *getMultipassVertexBuffer( size_t numElements, size_t textNumElements );
 		GlyphVertex *getMultipassTextVertexBuffer( size_t numElements, size_t textNumElements );
 
@@ -325,6 +536,9 @@ namespace Colibri
 
 		void updateZOrderDirty();
 
+		/// See _notifyDirtyRegion
+		void addToDirtyRegion( Renderable *renderable );
+
 		/// Ensure its immediate parent window has the given widget within its visible bounds.
 		void scrollToWidget( Widget *widget );
 
@@ -366,6 +580,30 @@ namespace Colibri
 
 		bool isMultipass() const { return m_multipass; }
 
+		/** Multipass only. By default a multipass ColibriManager fills the vertices in a
+			temporary CPU buffer and then uploads them to the GPU on every pass. This costs
+			a copy and a staging transfer per pass.
+
+			When the ring is enabled, the vertex buffers become persistently mapped and are
+			split into maxPassesPerFrame regions (for each frame in flight). Each call to
+			prepareRenderCommands in the same frame writes directly into its own region,
+			and render() draws from the region written by the last prepareRenderCommands.
+		@remarks
+			The vertex buffers will be maxPassesPerFrame times larger (per frame in flight).
+
+			If prepareRenderCommands gets called more than maxPassesPerFrame times in the same
+			frame, the extra passes will overwrite the last region while the GPU may still be
+			reading from it (rendering glitches) and an error is logged.
+
+			Retained mode (setRetainedVertexBuffers) is ignored while the ring is enabled as
+			each pass writes into a different region.
+		@param maxPassesPerFrame
+			Maximum number of times prepareRenderCommands will be called per frame.
+			0 to disable the ring (default).
+		*/
+		void setMultipassRingSize( uint32_t maxPassesPerFrame );
+		uint32_t getMultipassRingSize() const { return m_multipassRingSize; }
+
 		void setOgre( Ogre::Root *colibri_nullable root, Ogre::VaoManager *colibri_nullable vaoManager,
 					  Ogre::SceneManager *colibri_nullable sceneManager );
 		Ogre::ObjectMemoryManager* getOgreObjectMemoryManager()		{ return m_objectMemoryManager; }
@@ -373,6 +611,49 @@ namespace Colibri
 		Ogre::SceneManager* getOgreSceneManager()					{ return m_sceneManager; }
 		Ogre::VertexArrayObject* getVao()							{ return m_vao; }
 		Ogre::VertexArrayObject* getTextVao()						{ return m_textVao; }
+		/// For internal use. The Vao widgets hold to describe their vertex format.
+		/// See m_vertexFormatVao
+		Ogre::VertexArrayObject *_getVertexFormatVao() { return m_vertexFormatVao; }
+		Ogre::VertexArrayObject *_getTextVertexFormatVao() { return m_textVertexFormatVao; }
+
+		/** Pre-sizes the vertex buffers so they can hold at least the given number of widgets
+			and glyphs. Growing the buffers means reallocating them, which can cause a hitch
+			(e.g. when opening a big inventory for the first time). Call this at load time to
+			avoid that during gameplay.
+
+			Buffers are never shrunk by this function.
+		@remarks
+			setOgre (or _setPrimary) must have been called first.
+		@param numWidgets
+			Number of widgets that aren't Labels, LabelBmps or CustomShapes.
+		@param numGlyphs
+			Number of glyphs across all Labels.
+		*/
+		void reserve( uint32_t numWidgets, uint32_t numGlyphs );
+
+		/** Shrinks the vertex buffers to what's currently needed (but never below what was
+			requested via reserve). Vertex buffers never shrink on their own unless
+			setAutoTrimBuffers is used, thus call this after destroying a lot of widgets
+			(e.g. after a loading screen with a huge credits roll).
+		@remarks
+			Do not call this while rendering.
+		*/
+		void trimBuffers();
+
+		/** Automatically shrinks the vertex buffers (see trimBuffers) once less than half of
+			their capacity has been used for numFrames consecutive calls to update.
+
+			The delay avoids reallocating back and forth when content is constantly created and
+			destroyed (e.g. popups).
+		@param numFrames
+			0 to disable (default).
+		*/
+		void setAutoTrimBuffers( uint32_t numFrames );
+		uint32_t getAutoTrimBuffers() const { return m_autoTrimFrames; }
+
+		/// Returns the usage of the vertex buffer for widgets (or text if bText).
+		VertexBufferStats getVertexBufferStats( bool bText ) const;
+		void resetVertexBufferHighWaterMarks();
 		Ogre::HlmsDatablock * colibri_nonnull * colibri_nullable getDefaultTextDatablock()
 																	{ return m_defaultTextDatablock; }
 		Ogre::HlmsManager *getOgreHlmsManager();
@@ -425,6 +706,142 @@ namespace Colibri
 		void setTouchOnlyMode( bool bTouchOnlyMode );
 		bool getTouchOnlyMode() const { return m_touchOnlyMode; }
 
+		/** Enables retained mode for the vertex buffers.
+
+			When disabled (default), every visible widget regenerates its vertices every frame.
+
+			When enabled, widgets only regenerate their vertices if their visuals changed
+			(e.g. they moved, were resized, changed colour, skin, state, text, etc) or their
+			location in the vertex buffer changed (e.g. a widget before them was culled).
+			Static UIs become much cheaper to update.
+
+			Scrolling a Window does not count as a change: the scroll & clipping region are
+			applied by the vertex shader (see DrawParams).
+		@remarks
+			When in retained mode, modifying PUBLIC VARIABLES that affect the visuals of a widget
+			requires calling Renderable::setVisualsDirty afterwards.
+
+			Use getNumVerticesRewritten & getNumTextVerticesRewritten to measure the savings.
+		@param bRetained
+			True to enable retained mode.
+		*/
+		void setRetainedVertexBuffers( bool bRetained );
+		bool getRetainedVertexBuffers() const { return m_retainedVertexBuffers; }
+
+		/// Returns the number of UiVertex that were written during the last prepareRenderCommands.
+		/// This includes widgets that don't support retained mode (e.g. CustomShape, LabelBmp).
+		uint32_t getNumVerticesRewritten() const { return m_numVerticesRewritten.load(); }
+		/// Returns the number of GlyphVertex that were written during the last
+		/// prepareRenderCommands.
+		uint32_t getNumTextVerticesRewritten() const { return m_numTextVerticesRewritten.load(); }
+
+		/// Returns the number of draws (i.e. consecutive Renderables sharing the same
+		/// datablock & vertex buffer) that subtrees with Widget::m_reorderDraws would've
+		/// needed during the last render without reordering.
+		uint32_t getNumDrawsBeforeReorder() const { return m_numDrawsBeforeReorder; }
+		/// Same as getNumDrawsBeforeReorder, but after reordering
+		uint32_t getNumDrawsAfterReorder() const { return m_numDrawsAfterReorder; }
+
+		/** When enabled, widgets whose children (and children's children, etc) are proven to
+			not overlap each other are rendered in breadth first order, as if Widget::m_breadthFirst
+			had been set. This is guaranteed to look the same as depth first, while often needing
+			a lot fewer draws (e.g. lists of buttons with text).
+
+			See Widget::_isSubtreeOverlapFree for the exact criteria.
+		@param bAutoBreadthFirst
+			True to enable. Default is false.
+		*/
+		void setAutoBreadthFirst( bool bAutoBreadthFirst );
+		bool getAutoBreadthFirst() const { return m_autoBreadthFirst; }
+
+		/// Returns the number of widgets that were automatically rendered in breadth first
+		/// during the last render. See setAutoBreadthFirst
+		uint32_t getNumAutoBreadthFirstContainers() const { return m_numAutoBreadthFirst; }
+
+		/// For internal use. See getNumAutoBreadthFirstContainers
+		void _notifyAutoBreadthFirstUsed() { ++m_numAutoBreadthFirst; }
+
+		/// For internal use. Adds the commands of widget's children. See Widget::m_reorderDraws
+		void _addReorderedChildrenCommands( Widget *widget, ApiEncapsulatedObjects &apiObject );
+
+		/** When enabled, render() remembers which Renderables it drew and in which order.
+			If nothing changed in the next frame (no widget got culled, unculled, created,
+			destroyed or reordered) render() walks that list instead of traversing every
+			window (including the breadth-first collection).
+
+			Draw commands are still emitted for each widget, thus changes to skins, states,
+			datablocks, colours, vertices, etc are always picked up.
+		@remarks
+			Modifying Widget::m_breadthFirst requires calling invalidateDrawList afterwards.
+		@param bCaching
+			True to enable. Default is false.
+		*/
+		void setDrawListCaching( bool bCaching );
+		bool getDrawListCaching() const { return m_drawListCaching; }
+
+		/// Forces render() to traverse all windows in the next frame.
+		/// See setDrawListCaching
+		void invalidateDrawList() { _notifyDrawListDirty(); }
+
+		/** When enabled, we keep track of the region of the canvas that must be redrawn
+			because something changed in it (i.e. the union of the rects of all widgets whose
+			visuals changed, before and after the change).
+
+			Things that can affect any part of the canvas (creating, destroying or reparenting
+			widgets, changing their z order, hiding windows, etc) mark the whole canvas dirty.
+
+			Use flushDirtyRegion to retrieve the region. This is mostly useful for
+			OffScreenCanvas, which only needs to redraw when something changed.
+		@remarks
+			flushDirtyRegion must be called every frame while this setting is enabled.
+		@param bTrack
+			True to enable. Default is false.
+		*/
+		void setDirtyRegionTracking( bool bTrack );
+		bool getDirtyRegionTracking() const { return m_dirtyRegionTracking; }
+
+		/// Marks the whole canvas as dirty. Useful after changes we can't track
+		/// (e.g. modifying a datablock directly). See setDirtyRegionTracking
+		void invalidateDirtyRegion() { _notifyDirtyRegionFull(); }
+
+		/** Retrieves the region that changed since the last call, and resets it.
+			Must be called after update() and before rendering.
+		@param outTopLeft [out]
+			Top left corner of the region, in the same space as Widget::getDerivedTopLeft
+			(i.e. in range [-1; 1], Y pointing down)
+		@param outBottomRight [out]
+			Bottom right corner of the region.
+		@return
+			False if nothing changed (outTopLeft and outBottomRight are left untouched).
+			Always returns true if setDirtyRegionTracking is disabled.
+		*/
+		bool flushDirtyRegion( Ogre::Vector2 &outTopLeft, Ogre::Vector2 &outBottomRight );
+
+		/** Sets the dispatcher used to fill the vertex buffers of each window (in m_windows)
+			in parallel during prepareRenderCommands.
+
+			When a dispatcher is set, each window (and all of its children) gets its own region
+			of the vertex buffers, calculated from the max number of vertices it could need.
+			Windows are then filled independently from each other as tasks, one per window.
+
+			The output is deterministic: it is the same regardless of how the dispatcher
+			schedules the tasks (e.g. the default TaskDispatcher, which runs them serially,
+			produces byte-identical results to a multithreaded one).
+		@remarks
+			Because each window reserves its upper bound, there may be gaps between windows.
+			These are never drawn.
+
+			If the upper bounds don't fit in the current vertex buffers (which can happen
+			if Widgets changed after the last call to update) we fall back to the
+			serial path for that frame.
+
+			The dispatcher must outlive ColibriManager, or be unset before destroying it.
+		@param dispatcher
+			Nullptr to disable (default). Windows are filled serially and packed tightly.
+		*/
+		void setTaskDispatcher( TaskDispatcher *colibri_nullable dispatcher );
+		TaskDispatcher *colibri_nullable getTaskDispatcher() const { return m_taskDispatcher; }
+
 		/**	Sets the default skins to be used when creating a new widget.
 			Usage:
 			@code
@@ -685,6 +1102,13 @@ namespace Colibri
 		*/
 		void _addCustomShapesVertexCountChange( int32_t vertexCountDiff );
 
+		/** Notify the manager that a widget switched between c_numNineSliceVertices and
+			c_numNineSlicePerCellVertices. See Renderable::updateNineSliceLayout
+		@param countDiff
+			1 when switching to c_numNineSlicePerCellVertices, -1 when switching back.
+		*/
+		void _addNineSlicesPerCellChange( int32_t countDiff );
+
 		/// Cannot be nullptr
 		void _stealKeyboardFocus( Widget *widget );
 
@@ -704,6 +1128,77 @@ namespace Colibri
 			return m_textVertexBufferBase;
 		}
 
+		/// For internal use. Returns the number of consecutive frames a widget whose visuals
+		/// changed must rewrite its vertices (since each frame in flight has its own region).
+		uint8_t _getVisualsDirtyFrameCount() const;
+
+		/// For internal use. See m_fillPassIdx
+		uint32_t _getFillPassIdx() const { return m_fillPassIdx; }
+
+		/// For internal use. Returns true if all widgets must rewrite their vertices
+		/// during the current fill pass, whether they're dirty or not.
+		bool _getRewriteAllVertices() const { return m_rewriteAllVertices; }
+
+		/// For internal use. Called when something that changes which Renderables get drawn,
+		/// or their order, changed (i.e. a widget got culled, created, destroyed, reordered).
+		void _notifyDrawListDirty() { m_drawListDirty.store( true, std::memory_order_relaxed ); }
+
+		/// For internal use. Called when the visuals of a renderable changed, or when it moved.
+		/// Must not be called while filling the buffers. See setDirtyRegionTracking
+		void _notifyDirtyRegion( Renderable *renderable )
+		{
+			if( m_dirtyRegionTracking )
+				addToDirtyRegion( renderable );
+		}
+
+		/// For internal use. See Widget::m_derivedTransformStale
+		void _notifyDerivedTransformStale( bool bStale )
+		{
+			if( bStale )
+			{
+				m_numStaleDerivedTransforms.fetch_add( 1u, std::memory_order_relaxed );
+				_invalidateDerivedTransformChecks();
+			}
+			else
+			{
+				m_numStaleDerivedTransforms.fetch_sub( 1u, std::memory_order_relaxed );
+			}
+		}
+
+		/// For internal use. Forces every widget to look for stale parents again.
+		/// See Widget::m_derivedTransformCheckedEpoch
+		void _invalidateDerivedTransformChecks()
+		{
+			m_staleDerivedTransformEpoch.fetch_add( 1u, std::memory_order_relaxed );
+		}
+
+		/// For internal use. See Widget::m_derivedTransformCheckedEpoch
+		uint32_t _getStaleDerivedTransformEpoch() const
+		{
+			return m_staleDerivedTransformEpoch.load( std::memory_order_relaxed );
+		}
+
+		/// For internal use. Returns true if any widget has Widget::m_derivedTransformStale set,
+		/// thus derived transforms must be checked before being used.
+		bool _hasStaleDerivedTransforms() const
+		{
+			return m_numStaleDerivedTransforms.load( std::memory_order_relaxed ) != 0u;
+		}
+
+		/// For internal use. Called when something that can affect any part of the canvas changed.
+		/// See setDirtyRegionTracking
+		void _notifyDirtyRegionFull();
+
+		/// For internal use. Called by widgets after writing their vertices.
+		void _notifyVerticesRewritten( uint32_t numVertices )
+		{
+			m_numVerticesRewritten.fetch_add( numVertices, std::memory_order_relaxed );
+		}
+		void _notifyTextVerticesRewritten( uint32_t numVertices )
+		{
+			m_numTextVerticesRewritten.fetch_add( numVertices, std::memory_order_relaxed );
+		}
+
 #if __clang__
 	#pragma clang diagnostic push
 	#pragma clang diagnostic ignored "-Wnullability-completeness"
@@ -10,6 +10,7 @@ COLIBRI_ASSUME_NONNULL_BEGIN
 namespace Ogre
 {
 	class CompositorPassColibriGuiProvider;
+	class CompositorTargetDef;
 }
 
 namespace Colibri
@@ -60,9 +61,19 @@ namespace Colibri
 
 		Ogre::TextureGpu *colibri_nullable m_canvasTexture;
 
+		/// See setPartialUpdates
+		bool m_partialUpdates;
+		/// Target of the workspace definition used by createWorkspace when m_partialUpdates
+		/// is enabled. Null if m_workspace doesn't come from it.
+		Ogre::CompositorTargetDef *colibri_nullable m_partialTargetDef;
+
 		void createWorkspaceDefinition();
+		void createPartialWorkspaceDefinition();
 		void destroyWorkspace();
 
+		/// Restricts drawing to the given region. See ColibriManager::flushDirtyRegion
+		void setScissorRegion( const Ogre::Vector2 &topLeft, const Ogre::Vector2 &bottomRight );
+
 	public:
 		OffScreenCanvas( ColibriManager *primaryManager );
 		~OffScreenCanvas();
@@ -181,12 +192,36 @@ namespace Colibri
 
 		Ogre::CompositorWorkspace *colibri_nullable getWorkspace() { return m_workspace; }
 
+		/** When enabled, updateCanvas only renders if something changed since the last time
+			(see ColibriManager::setDirtyRegionTracking).
+
+			Additionally, if the workspace is created with createWorkspace() while this setting
+			is enabled, only the region that changed gets cleared and redrawn.
+			The rest of the texture keeps its previous contents.
+		@remarks
+			Changes Colibri can't track (e.g. modifying a datablock directly) require calling
+			ColibriManager::invalidateDirtyRegion on getSecondaryManager().
+			<br/>
+			Drawing gets restricted to the dirty region through scissor testing, which
+			HlmsColibri enables on every datablock it creates. Macroblocks later assigned
+			with HlmsDatablock::setMacroblock must keep mScissorTestEnabled set.
+		@param bPartialUpdates
+			True to enable. Default is false.
+		*/
+		void setPartialUpdates( bool bPartialUpdates );
+		bool getPartialUpdates() const { return m_partialUpdates; }
+
 		/** Updates and renders the off-screen canvas.
 		@param timeSinceLast
 			Time in seconds since last call. Used for animations (if any) as well as anything
 			else that requires time (like time stroke repeats).
+		@return
+			True if the canvas was rendered.
+			False if it was skipped because nothing changed (only when setPartialUpdates is
+			enabled), which means the texture still has the same contents (e.g. no need to
+			regenerate its mipmaps).
 		*/
-		void updateCanvas( const float timeSinceLast );
+		bool updateCanvas( const float timeSinceLast );
 	};
 }  // namespace Colibri
 
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "ColibriGui/ColibriGuiPrerequisites.h"
+
+#include <vector>
+
+COLIBRI_ASSUME_NONNULL_BEGIN
+
+namespace Colibri
+{
+	/** @ingroup Controls
+	@class OffScreenCanvasScheduler
+		Updates many OffScreenCanvas instances, so that you don't have to call
+		OffScreenCanvas::updateCanvas on each of them every frame.
+
+		Each canvas gets registered with a target refresh rate and a priority.
+		Every frame, canvases that are due are updated in order of urgency (their
+		priority, multiplied by how late they are) until either the maximum number
+		of canvases per frame or the time budget is reached.
+
+		Canvases that are late get more urgent every frame, so low priority canvases
+		are delayed but never starved.
+
+		Example:
+
+		@code
+			Colibri::OffScreenCanvasScheduler scheduler;
+			scheduler.setMaxRendersPerFrame( 4u );
+			scheduler.setTimeBudget( 0.002f );
+
+			// A clock that only needs to refresh once per second
+			scheduler.addCanvas( clockCanvas, 1.0f );
+			// A minimap, as often as possible
+			scheduler.addCanvas( minimapCanvas, 0.0f, 10.0f );
+
+			// Every frame
+			scheduler.update( timeSinceLast );
+		@endcode
+
+		OffScreenCanvas::setPartialUpdates works well together with this class,
+		since canvases that didn't change don't count against the limits.
+	*/
+	class OffScreenCanvasScheduler
+	{
+	protected:
+		struct CanvasEntry
+		{
+			OffScreenCanvas *canvas;
+			/// In seconds. 0 means every frame.
+			float refreshPeriod;
+			float priority;
+			/// Time accumulated since the canvas was last updated.
+			float timeSinceUpdate;
+		};
+
+		struct DueCanvas
+		{
+			float urgency;
+			/// Index to m_canvases
+			size_t idx;
+		};
+
+		typedef std::vector<CanvasEntry> CanvasEntryVec;
+		typedef std::vector<DueCanvas>   DueCanvasVec;
+
+		CanvasEntryVec m_canvases;
+
+		/// Canvases that are due this frame, sorted by urgency.
+		/// Kept around to avoid allocations.
+		DueCanvasVec m_dueCanvases;
+
+		uint32_t m_maxRendersPerFrame;
+		float    m_timeBudget;
+
+		uint32_t m_numDueLastFrame;
+		uint32_t m_numUpdatedLastFrame;
+		uint32_t m_numRenderedLastFrame;
+
+		CanvasEntryVec::iterator findCanvas( OffScreenCanvas *canvas );
+
+		static bool compareUrgency( const DueCanvas &a, const DueCanvas &b );
+
+	public:
+		OffScreenCanvasScheduler();
+
+		/** Registers a canvas to be updated by us. We don't take ownership.
+		@param canvas
+			Canvas to register. Must not already be registered.
+		@param refreshRate
+			How many times per second the canvas should be updated.
+			Use 0 to update it every frame (budget permitting).
+		@param priority
+			How important the canvas is, relative to the others (e.g. the inverse of its
+			distance to the camera). Must be greater than 0.
+		*/
+		void addCanvas( OffScreenCanvas *canvas, float refreshRate, float priority = 1.0f );
+
+		/// Unregisters the canvas. Must be called before destroying a registered canvas.
+		void removeCanvas( OffScreenCanvas *canvas );
+
+		/// Changes the refresh rate of a registered canvas. See addCanvas
+		void setRefreshRate( OffScreenCanvas *canvas, float refreshRate );
+
+		/// Changes the priority of a registered canvas. See addCanvas
+		void setPriority( OffScreenCanvas *canvas, float priority );
+
+		/// Forces the canvas to be updated as soon as possible (e.g. it just became visible).
+		void scheduleUpdate( OffScreenCanvas *canvas );
+
+		/** Sets the maximum number of canvases that can be rendered per frame.
+			Canvases that skip rendering because nothing changed (see
+			OffScreenCanvas::setPartialUpdates) are not counted.
+		@param maxRendersPerFrame
+			0 for no limit. Default is 0.
+		*/
+		void setMaxRendersPerFrame( uint32_t maxRendersPerFrame );
+		uint32_t getMaxRendersPerFrame() const { return m_maxRendersPerFrame; }
+
+		/** Sets how much CPU time can be spent updating canvases per frame.
+			Once exceeded, remaining canvases are delayed to the next frame.
+			At least one canvas is always updated if any is due.
+		@param seconds
+			0 for no limit. Default is 0.
+		*/
+		void setTimeBudget( float seconds );
+		float getTimeBudget() const { return m_timeBudget; }
+
+		/** Updates the canvases that are due, within the limits.
+			See setMaxRendersPerFrame and setTimeBudget
+		@param timeSinceLast
+			Time in seconds since last call.
+		*/
+		void update( float timeSinceLast );
+
+		/// Number of canvases that were due during the last update (including the ones
+		/// that got delayed because of the limits).
+		uint32_t getNumDueLastFrame() const { return m_numDueLastFrame; }
+		/// Number of canvases whose OffScreenCanvas::updateCanvas got called
+		/// during the last update
+		uint32_t getNumUpdatedLastFrame() const { return m_numUpdatedLastFrame; }
+		/// Number of canvases that were actually rendered during the last update
+		uint32_t getNumRenderedLastFrame() const { return m_numRenderedLastFrame; }
+	};
+}  // namespace Colibri
+
+COLIBRI_ASSUME_NONNULL_END
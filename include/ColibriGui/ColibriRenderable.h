@@ -5,11 +5,13 @@
 #include "ColibriGui/Ogre/ColibriOgreRenderable.h"
 
 #include "OgreColourValue.h"
+#if COLIBRI_COMPACT_VERTICES
+#	include "OgreBitwise.h"
+#endif
 
 namespace Ogre
 {
-	struct CbDrawCallStrip;
-	struct CbDrawStrip;
+	struct CbDrawCall;
 	class HlmsColibri;
 }
 
@@ -27,29 +29,111 @@ namespace Colibri
 		float			centerAspectRatio;
 		Ogre::ColourValue defaultColour;
 		Ogre::IdString	materialName;
+		/// True if the UVs of all visible cells (cells with a border of 0 are invisible) form
+		/// a 4x4 grid, i.e. adjacent cells share their edges exactly. See Renderable::addNineSlice.
+		/// When false the widget falls back to 6 vertices per cell, drawn without indices.
+		/// Calculated by SkinManager when the skin is loaded.
+		bool			sharedUvGrid;
 	};
 
+	/// Regular widgets are a 4x4 grid of vertices (which forms the 9-slice),
+	/// rendered using ColibriOgreRenderable::createIndexBuffer's shared index buffer
+	static const uint32_t c_numNineSliceVertices = 16u;
+	static const uint32_t c_numNineSliceIndices = 6u * 9u;
+	/// The shared index buffer is 16-bit, thus a single draw can't span more 9-slices than this
+	static const uint32_t c_maxNineSlicesPerDraw = 65536u / c_numNineSliceVertices;
+	/// 9-slices whose skin doesn't have a StateInformation::sharedUvGrid use
+	/// 6 vertices per cell instead (see Renderable::addQuad)
+	static const uint32_t c_numNineSlicePerCellVertices = 6u * 9u;
+	/// Glyphs are quads (TL, BL, BR, TR) rendered using
+	/// ColibriOgreRenderable::createGlyphIndexBuffer's shared index buffer.
+	/// That is 1.5x less vertex data than the 6 vertices per glyph we used to have.
+	/// A GlyphVertex is 40 bytes (32 with COLIBRI_COMPACT_VERTICES 1, 28 with 2),
+	/// thus a glyph takes 160 bytes (128, 112).
+	///
+	/// Pulling one record per glyph from a shader buffer in the vertex shader would need even
+	/// less data. Reading buffers from shaders isn't the problem (the glyph atlas already is a
+	/// TexBuffer / ReadOnlyBuffer). What's missing is everything around the text VAO:
+	/// retained vertices, the multipass ring, the per-Window fill slices and growing/trimming
+	/// all manage GlyphVertex as a vertex buffer, and HlmsColibri would need to bind the
+	/// glyph buffer to the vertex shader, at the right ring offset, in GLSL, HLSL & Metal.
+	static const uint32_t c_numGlyphVertices = 4u;
+	static const uint32_t c_numGlyphIndices = 6u;
+	static const uint32_t c_maxGlyphsPerDraw = 65536u / c_numGlyphVertices;
+
+#if COLIBRI_COMPACT_VERTICES
+	/// Half precision float stored as uint16_t. It converts from/to float on assignment,
+	/// thus code writing vertices doesn't need to care about COLIBRI_COMPACT_VERTICES.
+	struct HalfFloat
+	{
+		uint16_t value;
+
+		HalfFloat &operator=( float f )
+		{
+			value = Ogre::Bitwise::floatToHalf( f );
+			return *this;
+		}
+		operator float() const { return Ogre::Bitwise::halfToFloat( value ); }
+	};
+	typedef HalfFloat VertexClipFloat;
+#else
+	typedef float VertexClipFloat;
+#endif
+#if COLIBRI_COMPACT_VERTICES > 1
+	typedef HalfFloat VertexPosFloat;
+#else
+	typedef float VertexPosFloat;
+#endif
+
 	struct UiVertex
 	{
-		float x;
-		float y;
+		VertexPosFloat x;
+		VertexPosFloat y;
 		uint16_t u;
 		uint16_t v;
 		uint8_t rgbaColour[4];
-		float clipDistance[Borders::NumBorders];
+		/// Distance to the borders of the widget's own rect (normalized to its size, see
+		/// Renderable::getVertexClipRectSize). DrawParams turn it into the distance to the
+		/// actual clipping region.
+		VertexClipFloat clipDistance[Borders::NumBorders];
 	};
 
 	struct GlyphVertex
 	{
-		float x;
-		float y;
+		VertexPosFloat x;
+		VertexPosFloat y;
 		uint16_t width;
 		uint16_t height;
+		/// See Renderable::m_textDrawSlot
+		uint16_t drawSlot;
+		uint16_t unused;
 		uint32_t offset;
 		uint32_t rgbaColour;
-		float clipDistance[Borders::NumBorders];
+		/// See UiVertex::clipDistance
+		VertexClipFloat clipDistance[Borders::NumBorders];
 	};
 
+	/** Per-widget values the vertex shader applies on top of the vertices.
+		Things that change often but uniformly for the whole widget (the scroll of the Windows
+		it lives in, and the region it gets clipped to) live here instead of being baked into
+		the vertices. Thus they don't need to be regenerated when a Window scrolls.
+		See ColibriManager::setRetainedVertexBuffers.
+
+		It's written by HlmsColibri::fillBuffersForColibri, right after the material index.
+	*/
+	struct DrawParams
+	{
+		/// Added to the final position (NDC) of each vertex.
+		float posOffset[2];
+		/// For each border, the vertex shader does:
+		///		clipDistance = vertex.clipDistance * clipScale + clipBias;
+		/// clipScale[0] is used by Left & Right, clipScale[1] by Top & Bottom.
+		float clipScale[2];
+		float clipBias[Borders::NumBorders];
+	};
+	static_assert( sizeof( DrawParams ) == sizeof( float ) * 8u,
+				   "DrawParams must match what the vertex shader reads" );
+
 	/** @ingroup Api_Backend
 	@class ApiEncapsulatedObjects
 		This structure encapsulates API-specific pointers required for rendering.
@@ -71,16 +155,27 @@ namespace Colibri
 		Ogre::IndirectBufferPacked	*indirectBuffer;
 		uint8_t						*indirectDraw;
 		uint8_t						*startIndirectDraw;
-		//Used to see if we need to switch to a new draw when rendering text (since text rendering
-		//has arbitrary number of of vertices, thus we can't properly calculate the drawId and
-		//therefore the material ID)
+		/// Datablock of the last widget that added draws
 		Ogre::HlmsDatablock			*lastDatablock;
 		int							baseInstanceAndIndirectBuffers;
-		Ogre::CbDrawCallStrip		* colibri_nullable drawCmd;
-		Ogre::CbDrawStrip			* colibri_nullable drawCountPtr;
+		Ogre::CbDrawCall			* colibri_nullable drawCmd;
+		/// Points to the primCount of the last CbDrawIndexed or CbDrawStrip
+		uint32_t					* colibri_nullable drawCountPtr;
+		/// True if drawCmd is a CbDrawCallIndexed (9-slices), false if it's a CbDrawCallStrip
+		bool drawCmdIndexed;
 		uint32_t primCount;
+		Ogre::VertexArrayObject *vao[2]; //[0] = regular widgets, [1] = text
 		uint32_t basePrimCount[2]; //[0] = regular widgets, [1] = text
 		uint32_t nextFirstVertex;
+		/// Number of Labels in the current indirect draw, if the last thing added to it was a
+		/// Label another one can be chained to. 0 otherwise. See Renderable::m_textDrawSlot
+		uint32_t textChainLength;
+		/// Renderable::m_textDrawSlot & m_nextTextDrawSlot of the last Label in the chain
+		uint16_t textDrawSlot;
+		uint16_t nextTextDrawSlot;
+		/// When not null, Renderables that aren't culled push themselves here
+		/// in the order they were visited. See ColibriManager::setDrawListCaching
+		std::vector<Renderable *> *colibri_nullable drawList;
 	};
 
 	/**
@@ -101,14 +196,45 @@ namespace Colibri
 		Ogre::ColourValue m_colour;
 
 	protected:
-		/// WARNING: Most of the code assumes m_numVertices is hardcoded to 6*9;
+		/// WARNING: Most of the code assumes m_numVertices is hardcoded to c_numNineSliceVertices;
 		/// this value is dynamic because certain widgets (such as Labels) can
 		/// have arbitrary number of vertices and the rest of the code
 		/// also acknowledges that!
 		uint32_t			m_numVertices;
 		uint32_t			m_currVertexBufferOffset;
 
+		/// Number of frames we still need to regenerate our vertices for.
+		/// See ColibriManager::setRetainedVertexBuffers
+		uint8_t  m_visualsDirty;
+		/// Value of ColibriManager::_getFillPassIdx the last time our vertices were
+		/// either written or retained. Used to detect we were culled in between.
+		uint32_t m_lastFillPassIdx;
+
+		/// See updateDrawParams
+		DrawParams m_drawParams;
+
+		/// Region of the canvas we covered the last time we were drawn, scroll included.
+		/// Empty if we were never drawn. See ColibriManager::setDirtyRegionTracking
+		Ogre::Vector2 m_lastDrawnTopLeft;
+		Ogre::Vector2 m_lastDrawnBottomRight;
+
+		/// See setExtraDrawParams
+		uint32_t const *colibri_nullable m_extraDrawParams;
+		uint32_t                         m_numExtraDrawParams;
+
+		/// Labels only. Value baked into each GlyphVertex::drawSlot. Consecutive Labels can share
+		/// the same indirect draw if their slots are consecutive too: the vertex shader finds
+		/// each Label's instance data (material & DrawParams) from the slot difference.
+		/// See _addDrawCommands
+		uint16_t m_textDrawSlot;
+		/// Slot _addDrawCommands wants to chain us to a previous Label. It becomes
+		/// m_textDrawSlot the next time our vertices are regenerated.
+		uint16_t m_nextTextDrawSlot;
+
 		bool m_visualsEnabled;
+		/// True if the current state's skin doesn't have a StateInformation::sharedUvGrid.
+		/// See updateNineSliceLayout
+		bool m_nineSlicePerCell;
 
 	public:
 		/// When false (default), behaves normally.
@@ -125,26 +251,120 @@ namespace Colibri
 		/// @copydoc Widget::addChildrenCommands
 		void _addCommands( ApiEncapsulatedObjects &apiObject, bool collectingBreadthFirst );
 
+		/// Adds the commands to draw this widget alone (not its children).
+		/// See ColibriManager::setDrawListCaching
+		void _addDrawCommands( ApiEncapsulatedObjects &apiObject );
+
+		/// Takes back the last indirect draw if no primitives ended up being added to it
+		static void _discardEmptyDraw( ApiEncapsulatedObjects &apiObject );
+
 	protected:
-		inline void addQuad( UiVertex * RESTRICT_ALIAS vertexBuffer,
-							 Ogre::Vector2 topLeft,
-							 Ogre::Vector2 bottomRight,
-							 Ogre::Vector4 uvTopLeftBottomRight,
-							 uint8_t *rgbaColour,
-							 Ogre::Vector2 parentDerivedTL,
-							 Ogre::Vector2 parentDerivedBR,
-							 Ogre::Vector2 invSize,
-							 float canvasAspectRatio,
-							 float invCanvasAspectRatio,
-							 Matrix2x3 parentRot );
+		static inline void addQuad( UiVertex * RESTRICT_ALIAS vertexBuffer,
+									Ogre::Vector2 topLeft,
+									Ogre::Vector2 bottomRight,
+									Ogre::Vector4 uvTopLeftBottomRight,
+									uint8_t *rgbaColour,
+									Ogre::Vector2 parentDerivedTL,
+									Ogre::Vector2 parentDerivedBR,
+									Ogre::Vector2 invSize,
+									float canvasAspectRatio,
+									float invCanvasAspectRatio,
+									Matrix2x3 parentRot );
+
+		/** Emits the 16 unique corners of the 9-slice (row major) using SSE2 / NEON when
+			available. Triangles are formed by the shared index buffer.
+		@param gridX
+			Columns of the grid: Outer left, inner left, inner right, outer right.
+		@param gridY
+			Rows of the grid: Outer top, inner top, inner bottom, outer bottom.
+		@param uvTopLeftBottomRight
+			UVs of each cell. See StateInformation::uvTopLeftBottomRight
+			Only the corner & center cells are read. Thus the skin must have a
+			StateInformation::sharedUvGrid, otherwise use addQuad for each cell.
+		@param parentDerivedTL
+			Together with parentDerivedBR & invSize, the rect clip distances are relative to.
+			See UiVertex::clipDistance
+		@remarks
+			Benchmarks/NineSlice.cpp measures this against the 9 x addQuad path.
+		*/
+		static inline void addNineSlice( UiVertex * RESTRICT_ALIAS vertexBuffer,
+										 const float gridX[colibri_nonnull 4],
+										 const float gridY[colibri_nonnull 4],
+										 const Ogre::Vector4 *colibri_nonnull uvTopLeftBottomRight,
+										 const uint8_t *colibri_nonnull rgbaColour,
+										 Ogre::Vector2 parentDerivedTL,
+										 Ogre::Vector2 parentDerivedBR,
+										 Ogre::Vector2 invSize,
+										 float canvasAspectRatio,
+										 float invCanvasAspectRatio,
+										 const Matrix2x3 &derivedRot );
+
+		/// Switches between the shared 16 vertices 9-slice and 6 vertices per cell,
+		/// based on the current state's StateInformation::sharedUvGrid.
+		/// Must be called whenever the current StateInformation may have changed.
+		void updateNineSliceLayout();
 
 		void _notifyCanvasChanged() override;
 
 		void stateChanged( States::States newState ) override;
 
+		/** Must be called when filling the vertex buffer, right before writing our vertices.
+		@param vertexBufferOffset
+			Offset (in vertices) where our vertices will be placed this frame.
+		@return
+			True if the vertices must be generated.
+			False if the ones written in previous frames are still valid and can be skipped.
+		*/
+		bool beginVisualsUpdate( uint32_t vertexBufferOffset );
+
+		/** Updates m_drawParams. Must be called every frame we're not culled, whether our
+			vertices get regenerated or not (i.e. before beginVisualsUpdate).
+		@param clipTL
+			Top left of the region we're being clipped to, in NDC.
+		@param clipBR
+			Bottom right of the region we're being clipped to, in NDC.
+		@param bSnapToPixels
+			When true, the scroll translation is rounded to whole pixels, so that vertices
+			that were snapped to pixels stay that way after scrolling (i.e. text).
+		*/
+		void updateDrawParams( const Ogre::Vector2 &clipTL, const Ogre::Vector2 &clipBR,
+							   bool bSnapToPixels = false );
+
+		/** Sets additional per-draw constants, written to the instance buffer right after
+			m_drawParams. The shaders can read them at worldMaterialIdx[drawId + 3u + i].
+			Useful to avoid baking per-widget values into shaders (which causes one shader
+			per widget).
+
+			Only CustomShapes can use them, since they always start a new draw.
+		@param data
+			Array of numEntries uint4 (i.e. 4 * numEntries uint32_t). Must remain valid
+			until this function gets called again. Can be null if numEntries is 0.
+		@param numEntries
+			Number of uint4 entries.
+		*/
+		void setExtraDrawParams( uint32_t const *colibri_nullable data, uint32_t numEntries );
+
+		/** Grows the given region so that it includes the area we covered the last time
+			we were drawn, and the area we will cover in the next draw.
+			See ColibriManager::setDirtyRegionTracking
+		@param inOutTopLeft [in/out]
+		@param inOutBottomRight [in/out]
+		*/
+		void _addToDirtyRegion( Ogre::Vector2 &inOutTopLeft, Ogre::Vector2 &inOutBottomRight ) const;
+
+		/// Vertices' clip distances are relative to the rect that starts at m_derivedTopLeft
+		/// and has this size (which is our size, but never 0). See UiVertex::clipDistance
+		Ogre::Vector2 getVertexClipRectSize() const;
+
+		/// Returns m_derivedOrientation without the translation in DrawParams::posOffset.
+		/// Vertices must be generated with this matrix, since the vertex shader adds it back.
+		Matrix2x3 getVertexOrientation() const;
+
 	public:
 		Renderable( ColibriManager *manager );
 
+		void _destroy() override;
+
 		/** Disables drawing this widget, but it is still active. That means you can click on it,
 			highlight it, navigate to it via the keyboard, etc; as if everything were normal.
 
@@ -163,6 +383,15 @@ namespace Colibri
 		void setVisualsEnabled( bool bEnabled );
 		bool isVisualsEnabled() const final;
 
+		/** Flags our vertices to be regenerated.
+		@remarks
+			This is only relevant when ColibriManager::setRetainedVertexBuffers is enabled.
+			All setters already call this function. You only need to call it yourself after
+			directly modifying a PUBLIC VARIABLE that affects how the widget looks
+			(e.g. m_ignoreParentClipBorder, Label::m_clipTextToWidget)
+		*/
+		void setVisualsDirty();
+
 		/** Sets a custom colour
 		@param overrideSkinColour
 			When false, we ignore 'colour' argument and reset back to using the skin's default
@@ -218,6 +447,8 @@ namespace Colibri
 
 		void setState( States::States state, bool smartHighlight=true ) override;
 
+		void setTransformDirty( uint32_t dirtyReason ) override;
+
 		/** Calls setClipBorders and makes the clipping region to match that of the current skin
 
 			IMPORTANT: Skins' border size is dependent on real resolution (not canvas), thus
@@ -227,11 +458,11 @@ namespace Colibri
 		void setClipBordersMatchSkin();
 		void setClipBordersMatchSkin( States::States state );
 
-		void broadcastNewVao( Ogre::VertexArrayObject *vao,
-									  Ogre::VertexArrayObject *textVao ) final;
-
 		bool isRenderable() const final	{ return true; }
 
+		void _getVertexCountUpperBound( size_t &inOutNumVertices,
+										size_t &inOutNumTextVertices ) const override;
+
 		const StateInformation& getStateInformation( States::States state = States::NumStates ) const;
 
 		inline void _fillBuffersAndCommands( UiVertex * colibri_nonnull * colibri_nonnull
@@ -51,6 +51,8 @@ namespace Colibri
 
 	typedef std::map<Ogre::IdString, SkinInfo> SkinInfoMap;
 	typedef std::map<Ogre::IdString, SkinPack> SkinPackMap;
+	/// Material name -> the texture it had before SkinManager::packSkinTextures
+	typedef std::map<Ogre::IdString, Ogre::TextureGpu *> PackedMaterialMap;
 
 	class SkinManager
 	{
@@ -58,6 +60,13 @@ namespace Colibri
 		SkinInfoMap		m_skins;
 		SkinPackMap		m_skinPacks;
 
+		/// See setPackSkinTextures
+		bool						m_packSkinTextures;
+		/// Materials the last packSkinTextures call could pack (even if left unpacked)
+		PackedMaterialMap			m_packedMaterials;
+		/// Texture arrays created by packSkinTextures. We own them
+		std::vector<Ogre::TextureGpu *> m_skinTextureArrays;
+
 		inline Ogre::Vector2 getVector2Array( const rapidjson::Value &jsonArray );
 		inline Ogre::Vector4 getVector4Array( const rapidjson::Value &jsonArray );
 
@@ -70,13 +79,25 @@ namespace Colibri
 									   StateInformation &stateInfo,
 									   const char *skinName, const char *filename );
 
+		/** Calculates StateInformation::sharedUvGrid
+		@remarks
+			Edges must match exactly, so the grid samples the same texels as drawing each
+			cell on its own. Cells made half a texel smaller on each side to avoid bleeding
+			(see loadSkins) don't share their edges, thus they fall back to per-cell quads.
+		*/
+		static bool hasSharedUvGrid( const StateInformation &stateInfo );
+
 		void loadSkins( const rapidjson::Value &skinsValue, const char *filename );
 		void loadSkinPacks( const rapidjson::Value &packsValue, const rapidjson::Value &skinsValue,
 							const char *filename );
 		void loadDefaultSkinPacks( const rapidjson::Value &packsValue, const char *filename );
 
+		/// Destroys all the textures in the array, and clears it
+		static void destroyTextureArrays( std::vector<Ogre::TextureGpu *> &textureArrays );
+
 	public:
 		SkinManager( ColibriManager *colibriManager );
+		~SkinManager();
 
 		bool isSamerOwner( const ColibriManager *colibriManager ) const
 		{
@@ -113,6 +134,49 @@ namespace Colibri
 
 		void loadSkins( const char *fullPath );
 		void loadSkins( const char *jsonString, const char *filename );
+
+		/** When enabled, every loadSkins call ends with a call to packSkinTextures.
+			Must be set before loading the skins.
+		@param bPackSkinTextures
+			True to enable. Default is false.
+		*/
+		void setPackSkinTextures( bool bPackSkinTextures );
+		bool getPackSkinTextures() const { return m_packSkinTextures; }
+
+		/** Skins whose materials use different textures can't be rendered in the same draw
+			because HlmsColibri must bind new textures in between.
+
+			This function copies the textures of the materials used by skins into 2D texture
+			arrays, and makes those materials sample from their slice in the array instead.
+			All those materials then end up sharing the same textures (and descriptor sets),
+			thus widgets with different skins can be batched together.
+
+			Only materials with a single 2D texture (diffuse_map) are packed.
+			Textures can only share an array if they have the same resolution, pixel format,
+			number of mipmaps and samplerblock; thus there will be one array for each such
+			combination (and textures that don't have a match are left untouched).
+
+			It's safe to call this function after each loadSkins. When new materials are
+			found, all the materials are repacked (so that skins loaded by different calls can
+			share arrays) and the arrays from the previous call are destroyed. Otherwise
+			this function does nothing.
+
+		@remarks
+			This function stalls until the textures are loaded. It should be called at
+			loading time.
+
+			The original textures are not destroyed, since other materials may use them.
+
+			The texture arrays are destroyed with the SkinManager, thus the ColibriManager
+			must be destroyed before Ogre's TextureGpuManager.
+		*/
+		void packSkinTextures();
+
+		/// Returns the texture arrays created by the last packSkinTextures call
+		const std::vector<Ogre::TextureGpu *> &getSkinTextureArrays() const
+		{
+			return m_skinTextureArrays;
+		}
 	};
 }
 
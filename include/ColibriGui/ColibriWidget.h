@@ -88,6 +88,9 @@ namespace Colibri
 
 		typedef std::vector<WidgetActionListenerRecord> WidgetActionListenerRecordVec;
 
+		/// See Widget::setHitTestGridEnabled
+		struct HitTestGrid;
+
 		/// Child and parent relationships are explicit, thus they're not tracked via
 		/// WidgetListener::notifyWidgetDestroyed
 		/// Can only be nullptr if 'this' is a Window.
@@ -132,6 +135,18 @@ namespace Colibri
 		bool					m_consumesScroll;
 
 		bool m_culled;
+		/// When true, our derived transform and the ones of all our children are out of date,
+		/// because we were hidden or culled while they needed updating.
+		/// They're updated when we become visible again, or when someone queries them.
+		bool m_derivedTransformStale;
+		/// Value of ColibriManager::_getStaleDerivedTransformEpoch when we last verified that
+		/// neither we nor our parents are stale. While it matches, updateStaleDerivedTransform
+		/// doesn't need to walk our parents.
+		mutable uint32_t m_derivedTransformCheckedEpoch;
+		/// Cached result of _isSubtreeOverlapFree. See ColibriManager::setAutoBreadthFirst
+		uint8_t m_overlapFreeState;
+		/// See setHitTestGridEnabled
+		HitTestGrid *colibri_nullable m_hitTestGrid;
 	public:
 		/// When true, this widgets and its children will be rendered in breadth first
 		/// order, instead of depth first.
@@ -169,6 +184,24 @@ namespace Colibri
 		/// @see	Widget::isUltimatelyBreadthFirst
 		bool m_breadthFirst;
 
+		/// When true, this widget's children (and their children, except Windows) are drawn in
+		/// an order that groups together the ones sharing the same datablock & vertex buffer.
+		/// e.g. a list of rows alternating between two skins can be drawn with 2 draws
+		/// instead of one per row.
+		///
+		/// Unlike m_breadthFirst, this is always safe: widgets whose rects overlap (or are
+		/// rotated) keep their painter's order relative to each other. Labels, LabelBmps
+		/// & CustomShapes can draw outside their rect, thus nothing is reordered across them.
+		///
+		/// The cost is proportional to the number of widgets in the subtree, every frame.
+		/// Use ColibriManager::getNumDrawsBeforeReorder & getNumDrawsAfterReorder to see
+		/// whether it pays off.
+		///
+		/// @remark	PUBLIC MEMEBER: CAN BE EDITED DIRECTLY
+		/// @remark	Ignored if this widget is rendered in breadth first. m_breadthFirst and
+		///			m_reorderDraws of widgets inside the subtree are ignored.
+		bool m_reorderDraws;
+
 		/// A value for any sort of use. Colibri does not use it in any way.
 		uint64_t m_userId;
 
@@ -185,6 +218,11 @@ namespace Colibri
 		Ogre::Vector2	m_derivedTopLeft;
 		Ogre::Vector2	m_derivedBottomRight;
 		Matrix2x3		m_derivedOrientation;
+		/// Translation caused by the scroll of all the Windows we're in. It's already included
+		/// in m_derivedTopLeft & co. and is expressed in the space Widget::mul outputs
+		/// (i.e. before applying the canvas aspect ratio).
+		/// Renderables write their vertices without it. See Renderable::getVertexOrientation
+		Ogre::Vector2	m_derivedScrollOffset;
 
 		Ogre::Vector2	m_clipBorderTL;
 		Ogre::Vector2	m_clipBorderBR;
@@ -218,6 +256,44 @@ namespace Colibri
 
 		void updateDerivedTransform( const Ogre::Vector2 &parentPos, const Matrix2x3 &parentRot );
 
+		/// Sets m_culled. If it changed, the manager's cached draw list is invalidated.
+		void setCulled( bool bCulled );
+
+		/** Sets m_culled. When culled, our derived transform (and our children's) is left
+			out of date until needed. Otherwise it gets updated, and the caller must process
+			our children (i.e. _fillBuffersAndCommands).
+		@return
+			bCulled
+		*/
+		bool setCulledAndUpdateDerivedTransform( bool bCulled, const Ogre::Vector2 &parentPos,
+												 const Matrix2x3 &parentRot );
+
+		/// See m_derivedTransformStale
+		void setDerivedTransformStale( bool bStale );
+
+		/// Brings our derived transform up to date if we, or one of our parents,
+		/// have m_derivedTransformStale set.
+		void updateStaleDerivedTransform() const;
+
+		/// Invalidates the cached result of _isSubtreeOverlapFree of
+		/// this widget and all its parents.
+		void invalidateOverlapFreeState();
+
+		/// Flags our hit test grid (if we have one) to be rebuilt the next time it's needed.
+		/// Must be called when a child is added, removed, moved, resized or reordered.
+		void invalidateHitTestGrid();
+
+		/// Rebuilds m_hitTestGrid from the local rects of our children. Windows are excluded.
+		void rebuildHitTestGrid();
+
+		/** Tests whether the cursor is over the given child, or one of its children.
+			See _setIdleCursorMoved
+		@return
+			FocusPair::widget is null if no widget is under the cursor.
+		*/
+		FocusPair hitTestChild( Widget *widget, const Ogre::Vector2 &newPosNdc,
+								const Ogre::Vector2 &currentScroll );
+
 		/** Notifies a parent that the input is about to be removed. It's similar to
 			notifyWidgetDestroyed, except this is explicitly about child-parent
 			relationships, as these relationships aren't tracked by listeners.
@@ -468,6 +544,24 @@ namespace Colibri
 		/// @copydoc m_childrenClickable
 		bool hasClickableChildren() const;
 
+		/** When enabled, this widget keeps a uniform grid of where its children are, so that
+			finding which child is under the mouse cursor doesn't have to test all of them.
+
+			Useful for Windows (or Widgets with clickable children) with thousands of
+			children (e.g. a spreadsheet or an inventory). The results are exactly the same
+			as without it.
+
+			The grid is built in local space, hence scrolling doesn't invalidate it. It gets
+			rebuilt the next time the cursor moves after a child is added, removed, moved,
+			resized or reordered.
+		@remarks
+			It is not worth it for a few dozen children.
+			Disabled by default.
+		@param bEnabled
+		*/
+		void setHitTestGridEnabled( bool bEnabled );
+		bool getHitTestGridEnabled() const { return m_hitTestGrid != 0; }
+
 		/** Sets the next widget to go to. For example if calling
 				a->setNextWidget( b, Borders::Right, true );
 			then when we're at 'a' and user hits the right button, we will switch to 'b'.
@@ -501,11 +595,34 @@ namespace Colibri
 
 		FocusPair _setIdleCursorMoved( const Ogre::Vector2 &newPosNdc );
 
+		/// Deprecated. Does nothing and Colibri no longer calls it: widgets point to a Vao
+		/// that never changes (see ColibriManager::_getVertexFormatVao).
+		/// Kept so that existing overrides still compile.
+		COLIBRI_DEPRECATED
 		virtual void broadcastNewVao( Ogre::VertexArrayObject *vao, Ogre::VertexArrayObject *textVao );
 
 		virtual void _updateDerivedTransformOnly( const Ogre::Vector2 &parentPos,
 												  const Matrix2x3 &parentRot );
 
+		/// Calls _updateDerivedTransformOnly, unless we're hidden or culled. In that case
+		/// our derived transform (and our children's) is left out of date until needed.
+		void _updateDerivedTransformIfVisible( const Ogre::Vector2 &parentPos,
+											   const Matrix2x3 &parentRot );
+
+		/** Adds the max number of vertices this widget and all of its children could write
+			during _fillBuffersAndCommands.
+		@remarks
+			_fillBuffersAndCommands must never write more than this, even if its state
+			is inconsistent: with a TaskDispatcher, each Window fills its own slice of the
+			vertex buffers in parallel, and the next Window's slice starts right after.
+		@param inOutNumVertices [in/out]
+			Number of UiVertex. The value gets incremented.
+		@param inOutNumTextVertices [in/out]
+			Number of GlyphVertex. The value gets incremented.
+		*/
+		virtual void _getVertexCountUpperBound( size_t &inOutNumVertices,
+												size_t &inOutNumTextVertices ) const;
+
 		/** Fills vertexBuffer & textVertBuffer for rendering, perfoming occlussion culling.
 			It also updates derived transforms. Derived classes change their functionality.
 			This function is mostly relevant in Renderable and its derived classes
@@ -565,6 +682,20 @@ namespace Colibri
 		/// @see	Widget::addChildrenCommands
 		bool isUltimatelyBreadthFirst() const;
 
+		/** Returns true if rendering this widget's children in breadth first is guaranteed to
+			look the same as rendering them in depth first. That is the case when, at every
+			level of the subtree, no children overlap each other and none of them is rotated.
+
+			Children can't be drawn outside their parent's rect, thus it's enough to test
+			siblings against each other. Labels, LabelBmps and CustomShapes can draw outside
+			their own rect, so they're assumed to overlap all of their siblings.
+		@remarks
+			The result is cached until the transform of a widget in the subtree changes,
+			or a child is added or removed.
+			See ColibriManager::setAutoBreadthFirst
+		*/
+		bool _isSubtreeOverlapFree();
+
 		/** Sets the new state, which affects skins.
 			The state is is broadcasted to our children.
 		@param state
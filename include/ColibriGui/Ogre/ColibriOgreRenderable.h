@@ -22,10 +22,18 @@ namespace Ogre
 	class ColibriOgreRenderable : public MovableObject, public Renderable
 	{
 	public:
+		/** Creates the Vao for regular widgets, CustomShapes and LabelBmp.
+		@param indexBuffer
+			See createIndexBuffer. Used by regular widgets (9-slices). We do not own it.
+		*/
 		static VertexArrayObject *createVao( uint32 vertexCount, VaoManager *vaoManager,
-											 bool bMultiPass );
+											 bool bMultiPass, IndexBufferPacked *indexBuffer );
+		/** Creates the Vao for Labels.
+		@param indexBuffer
+			See createGlyphIndexBuffer. We do not own it.
+		*/
 		static VertexArrayObject *createTextVao( uint32 vertexCount, VaoManager *vaoManager,
-												 bool bMultiPass );
+												 bool bMultiPass, IndexBufferPacked *indexBuffer );
 
 		static void destroyVao( VertexArrayObject *vao, VaoManager *vaoManager );
 
@@ -38,10 +46,17 @@ namespace Ogre
 							   Colibri::ColibriManager *colibriManager );
 		virtual ~ColibriOgreRenderable();
 
-		/** Creates a prefilled index buffer to be used & reused for rendering.
-		@param vaoManager
+		/** Creates a prefilled index buffer to be used & reused for rendering 9-slices.
+			It contains the 9-slice topology c_maxNineSlicesPerDraw times, so consecutive
+			widgets can be rendered in the same draw (see Renderable::_addCommands).
 		@return
+			Immutable 16-bit index buffer. Caller is responsible for destroying it.
 		*/
+		static IndexBufferPacked *createIndexBuffer( VaoManager *vaoManager );
+
+		/// Same as createIndexBuffer, but for glyph quads (c_maxGlyphsPerDraw of them).
+		/// Requires 192kb
+		static IndexBufferPacked *createGlyphIndexBuffer( VaoManager *vaoManager );
 		//static Ogre::IndexBufferPacked* createIndexBuffer( VaoManager *vaoManager );
 
 		//Overrides from MovableObject
@@ -106,9 +106,30 @@ namespace Ogre
 
 		void prepareRenderCommands();
 
+		/** Writes the per-widget data into the instance buffer.
+		@param baseVertex
+			First vertex of the widget. Labels also pack their draw slot in the upper bits
+			(see Colibri::Renderable::m_textDrawSlot).
+		@param drawParams
+			Array of 8 floats. See Colibri::DrawParams
+		@param extraDrawParams
+			Array of numExtraDrawParams uint4, written after drawParams.
+			See Colibri::Renderable::setExtraDrawParams
+		@param numExtraDrawParams
+			Number of uint4 in extraDrawParams. Can be 0.
+		@return
+			The drawId (baseInstance) to use. Each widget takes c_instanceEntriesPerWidget
+			entries, thus widgets drawn in the same draw are that many entries apart.
+		*/
 		uint32 fillBuffersForColibri( const HlmsCache *cache, const QueuedRenderable &queuedRenderable,
 									  bool casterPass, uint32 baseVertex, uint32 lastCacheHash,
-									  CommandBuffer *commandBuffer );
+									  const float *drawParams, const uint32 *extraDrawParams,
+									  uint32 numExtraDrawParams, CommandBuffer *commandBuffer );
+
+		/// How many uint4 each widget takes from the instance buffer:
+		/// materialIdx/shadowBias/identityProj/baseVertex followed by Colibri::DrawParams.
+		/// CustomShapes may take more (see Colibri::Renderable::setExtraDrawParams).
+		static const uint32 c_instanceEntriesPerWidget = 3u;
 
 		/// @copydoc HlmsPbs::getDefaultPaths
 		static void getDefaultPaths( String &outDataFolderPath, StringVector &outLibraryFoldersPaths );
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "ColibriGui/ColibriGuiPrerequisites.h"
+
+#include <vector>
+
+COLIBRI_ASSUME_NONNULL_BEGIN
+
+namespace Colibri
+{
+	/** Hash table of CachedGlyph, keyed by codepoint, ptSize and font.
+		Used by ShaperManager.
+
+		It uses open addressing with linear probing, hence lookups don't chase
+		pointers and don't allocate.
+
+		The glyphs themselves are kept in blocks that never move, thus the pointers
+		returned by find & insert (e.g. ShapedGlyph::glyph) stay valid until the
+		glyph is erased, even if the table grows.
+	*/
+	class GlyphCache
+	{
+	protected:
+		struct Bucket
+		{
+			uint32_t hash;
+			/// Index to the slot holding the glyph. c_emptyBucket if empty.
+			uint32_t slot;
+		};
+
+		typedef std::vector<Bucket>        BucketVec;
+		typedef std::vector<CachedGlyph *> CachedGlyphPtrVec;
+
+		/// Size is always a power of 2, or 0
+		BucketVec m_buckets;
+
+		/// Each block holds c_glyphsPerBlock glyphs. Slot N lives in
+		/// m_blocks[N / c_glyphsPerBlock][N % c_glyphsPerBlock]
+		CachedGlyphPtrVec     m_blocks;
+		std::vector<uint32_t> m_freeSlots;
+		uint32_t              m_numSlots;
+
+		size_t m_numGlyphs;
+
+		static uint32_t calculateHash( uint32_t codepoint, uint32_t ptSize, uint32_t fontIdx );
+
+		CachedGlyph *getSlot( uint32_t slot ) const;
+
+		/// Returns the index to m_buckets where the glyph is, or where it would be inserted
+		size_t findBucket( uint32_t hash, uint32_t codepoint, uint32_t ptSize,
+						   uint32_t fontIdx ) const;
+
+		void growBuckets();
+
+	public:
+		GlyphCache();
+		~GlyphCache();
+
+		// Glyphs are owned by their blocks. A copy would free them twice
+		GlyphCache( const GlyphCache & ) = delete;
+		GlyphCache &operator=( const GlyphCache & ) = delete;
+
+		/// Returns nullptr if the glyph is not in the cache
+		CachedGlyph *colibri_nullable find( uint32_t codepoint, uint32_t ptSize,
+											uint32_t fontIdx ) const;
+
+		/** Adds a copy of the glyph to the cache.
+		@param glyph
+			The glyph to copy. Its codepoint, ptSize & font are used as key.
+			Must not be in the cache already.
+		@return
+			The cached glyph. Stays valid until erased.
+		*/
+		CachedGlyph *insert( const CachedGlyph &glyph );
+
+		/// Removes the glyph from the cache. The pointer becomes dangling.
+		void erase( CachedGlyph *glyph );
+
+		size_t size() const { return m_numGlyphs; }
+
+		/** Used to iterate through all the glyphs, in no particular order:
+
+			@code
+				for( size_t i = 0u; i < cache.getNumBuckets(); ++i )
+				{
+					CachedGlyph *glyph = cache.getGlyphAtBucket( i );
+					if( glyph )
+						...
+				}
+			@endcode
+
+			Inserting or erasing glyphs while iterating may cause glyphs to be skipped or
+			visited twice.
+		*/
+		size_t getNumBuckets() const { return m_buckets.size(); }
+		/// See getNumBuckets. Returns nullptr if the bucket is empty.
+		CachedGlyph *colibri_nullable getGlyphAtBucket( size_t idx ) const;
+	};
+}  // namespace Colibri
+
+COLIBRI_ASSUME_NONNULL_END
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "ColibriGui/ColibriGuiPrerequisites.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+COLIBRI_ASSUME_NONNULL_BEGIN
+
+namespace Colibri
+{
+	/** Rasterizes glyphs in worker threads. Used by ShaperManager.
+		See ShaperManager::setAsyncRasterization
+
+		FreeType objects can't be shared between threads, thus each worker has its
+		own FT_Library and opens its own FT_Face of every font it needs.
+
+		Workers never touch the glyph cache or the atlas. They produce bitmaps which
+		ShaperManager copies to the atlas from the main thread.
+	*/
+	class GlyphRasterizer
+	{
+	public:
+		struct Request
+		{
+			/// Same as CachedGlyph::codepoint. Used as key
+			uint32_t codepoint;
+			/// Glyph to load from the font. Differs from codepoint for dummy glyphs
+			uint32_t glyphIndex;
+			uint32_t ptSize;
+			uint16_t font;
+			uint32_t dpi;
+			/// Must stay valid until the request is done
+			const char *fontPath;
+
+			/// Box reserved for the bitmap, in pixels. Same meaning as CachedGlyph's
+			/// bearingX, bearingY, width & height
+			int32_t  left;
+			int32_t  top;
+			uint16_t width;
+			uint16_t height;
+		};
+
+		struct Result
+		{
+			uint32_t codepoint;
+			uint32_t ptSize;
+			uint16_t font;
+			uint16_t width;
+			uint16_t height;
+			/// width * height bytes, tightly packed
+			std::vector<uint8_t> pixels;
+		};
+
+		typedef std::vector<Result> ResultVec;
+
+	protected:
+		std::vector<std::thread> m_threads;
+
+		std::mutex              m_mutex;
+		std::condition_variable m_workAvailable;
+		std::condition_variable m_workDone;
+
+		std::deque<Request> m_requests;
+		ResultVec           m_results;
+		/// Requests queued or being processed
+		size_t m_numInFlight;
+		bool   m_bExit;
+
+		void workerThread();
+
+	public:
+		GlyphRasterizer( uint32_t numThreads );
+		/// Pending requests are discarded
+		~GlyphRasterizer();
+
+		void queue( const Request &request );
+
+		/// Moves the bitmaps finished so far to outResults. Doesn't block
+		void fetchResults( ResultVec &outResults );
+
+		/// Blocks until every queued request is done
+		void finishPendingWork();
+
+		size_t getNumThreads() const { return m_threads.size(); }
+	};
+}  // namespace Colibri
+
+COLIBRI_ASSUME_NONNULL_END
@@ -65,6 +65,8 @@ namespace Colibri
 		/// See setUseCodepoint0ForRaster()
 		bool m_useCodepoint0ForRaster;
 
+		std::string m_fontLocation;
+
 		size_t renderWithSubstituteFont( const uint16_t *utf16Str, size_t stringLength,
 										 hb_direction_t dir, uint32_t richTextIdx,
 										 uint32_t clusterOffset, ShapedGlyphVec &outShapes,
@@ -81,6 +83,9 @@ namespace Colibri
 		void     setFontSize( FontSize ptSize );
 		FontSize getFontSize() const;
 
+		/// Path the font was loaded from
+		const std::string &getFontLocation() const { return m_fontLocation; }
+
 		/** When raster fonts are used, we need to fetch a dummy glyph to base our parameters
 			and align the raster glyphs (e.g. emoji).
 
@@ -3,6 +3,8 @@
 
 #include "ColibriGui/ColibriGuiPrerequisites.h"
 
+#include "ColibriGui/Text/ColibriGlyphCache.h"
+
 #include "OgrePrerequisites.h"
 
 #include <vector>
@@ -45,6 +47,16 @@ namespace Colibri
 		uint16_t font;
 		uint32_t refCount;
 
+		/// True while a worker thread is rasterizing it. Its metrics are final,
+		/// but its pixels in the atlas are still blank.
+		/// See ShaperManager::setAsyncRasterization
+		bool pendingRaster;
+
+		/// Links of the LRU list of unused glyphs (i.e. refCount == 0) it belongs to.
+		/// Owned by ShaperManager.
+		CachedGlyph *colibri_nullable lruPrev;
+		CachedGlyph *colibri_nullable lruNext;
+
 		size_t getSizeBytes() const;
 
 		bool isCodepointInPrivateArea() const;
@@ -67,38 +79,38 @@ namespace Colibri
 		{
 			size_t	offset;
 			size_t	size;
+
+			bool operator < ( const Range &other ) const { return offset < other.offset; }
 		};
-		struct GlyphKey
+
+		/// Unused glyphs of a size class, from most to least recently released
+		struct GlyphLruList
 		{
-			uint32_t codepoint;
-			uint32_t ptSize;
-			uint32_t fontIdx;
-			GlyphKey( uint32_t _codepoint, uint32_t _ptSize, uint32_t _fontIdx ) :
-				codepoint( _codepoint ), ptSize( _ptSize ), fontIdx( _fontIdx )
-			{
-				COLIBRI_ASSERT_MEDIUM( fontIdx != 0 );
-			}
-
-			bool operator < ( const GlyphKey &other ) const
-			{
-				if( this->codepoint != other.codepoint )
-					return this->codepoint < other.codepoint;
-
-				if( this->ptSize != other.ptSize )
-					return this->ptSize < other.ptSize;
-
-				if( this->fontIdx != other.fontIdx )
-					return this->fontIdx < other.fontIdx;
-
-				return false;
-			}
+			CachedGlyph *colibri_nullable head;
+			/// The coldest glyph. First in line for eviction.
+			CachedGlyph *colibri_nullable tail;
+
+			GlyphLruList() : head( 0 ), tail( 0 ) {}
 		};
 
+		typedef std::vector<GlyphLruList> GlyphLruListVec;
+
 		FT_Library	m_ftLibrary;
 		ColibriManager	*m_colibriManager;
 
-		typedef std::map<GlyphKey, CachedGlyph> CachedGlyphMap;
-		CachedGlyphMap	m_glyphCache;
+		/// Keyed by codepoint, ptSize & font
+		GlyphCache	m_glyphCache;
+
+		/// Glyphs with refCount == 0, indexed by size class. See getSizeClass
+		GlyphLruListVec m_unusedGlyphs;
+		size_t			m_numUnusedGlyphs;
+
+		size_t m_numCacheHits;
+		size_t m_numCacheMisses;
+		size_t m_numEvictions;
+
+		/// Incremented every time processRasterizedGlyphs copies glyphs to the atlas
+		uint32_t m_rasterizedGlyphsGeneration;
 
 		typedef std::vector<Range> RangeVec;
 
@@ -127,14 +139,44 @@ namespace Colibri
 		Ogre::HlmsColibri *colibri_nullable  m_hlms;
 		Ogre::VaoManager *colibri_nullable   m_vaoManager;
 
+		GlyphRasterizer *colibri_nullable m_glyphRasterizer;
+
 		void growAtlas( size_t sizeBytes );
 		size_t getAtlasOffset( size_t sizeBytes );
+
+		void destroyGpuBuffer( Ogre::BufferPacked *buffer );
+		/// Sorts m_dirtyRanges and merges the ones that overlap or are close enough
+		void coalesceDirtyRanges();
+		/// Uploads m_dirtyRanges to the GPU using a single staging buffer, then clears it
+		void uploadDirtyRanges();
+
+		/// Copies the bitmap of the glyph to its location in m_glyphAtlas,
+		/// and schedules the transfer to the GPU.
+		/// When srcData is nullptr, the glyph is cleared to 0 instead.
+		void copyToAtlas( const CachedGlyph &glyph, const uint8_t *colibri_nullable srcData,
+						  int srcPitch );
+
 		CachedGlyph *createGlyph( FT_Face font, uint32_t codepoint, uint32_t ptSize, uint16_t fontIdx,
 								  bool bDummy );
 		/// Used only for private areas
 		CachedGlyph *createRasterGlyph( FT_Face font, uint32_t codepoint, uint32_t ptSize,
 										uint16_t fontIdx, const bool bUseCodepoint0ForRaster );
-		void         destroyGlyph( CachedGlyphMap::iterator glyphIt );
+		void         destroyGlyph( CachedGlyph *glyph );
+
+		/** Returns the index to m_unusedGlyphs for a glyph of the given size.
+			Class 0 holds the glyphs that take no atlas space.
+
+			Class N holds glyphs in the range ( 2^(N-2); 2^(N-1) ] bytes,
+			thus evicting any glyph of class N+1 makes room for a glyph of class N.
+		*/
+		static size_t getSizeClass( size_t sizeBytes );
+		/// Adds the glyph to the front (most recent) of its LRU list
+		void linkUnusedGlyph( CachedGlyph *glyph );
+		void unlinkUnusedGlyph( CachedGlyph *glyph );
+		/// Returns a cold unused glyph whose eviction guarantees sizeBytes can be allocated:
+		/// one of the coldest few of its own size class if they're big enough,
+		/// otherwise the coldest of the smallest bigger class. Nullptr if there's none.
+		CachedGlyph *colibri_nullable findGlyphToEvict( size_t sizeBytes ) const;
 		void mergeContiguousBlocks( RangeVec::iterator blockToMerge, RangeVec &blocks );
 
 	public:
@@ -212,8 +254,58 @@ namespace Colibri
 		/// WARNING: const_casts cachedGlyph, which means it's not thread safe
 		void releaseGlyph( const CachedGlyph *cachedGlyph );
 
+		/// Destroys all glyphs that are no longer in use, freeing their atlas space.
+		/// Not needed in general, since the coldest unused glyphs get evicted when
+		/// we run out of space.
 		void flushReleasedGlyphs();
 
+		/** When enabled, acquireGlyph no longer rasterizes the glyphs that aren't cached.
+			Instead they're rasterized by a pool of worker threads, so that showing
+			lots of new text (e.g. CJK) doesn't stall the frame.
+
+			In the meantime these glyphs are cached with their final metrics (thus Labels
+			can be laid out) but blank pixels. Once ready, the pixels are copied to the
+			atlas and the Labels using them are redrawn. See processRasterizedGlyphs.
+		@remarks
+			The outline of the glyph is still loaded in the calling thread to obtain
+			its metrics. Only the rasterization is deferred.
+
+			Glyphs that have no outline (e.g. embedded bitmaps) are still loaded
+			synchronously.
+
+			Not available on Android, since fonts are read from the APK.
+		@param numThreads
+			Number of worker threads. 0 to rasterize synchronously (default).
+			When disabling, we wait for the glyphs that are still in flight
+			and the Labels using them are redrawn.
+		*/
+		void     setAsyncRasterization( uint32_t numThreads );
+		uint32_t getAsyncRasterizationThreads() const;
+
+		/** Copies to the atlas the glyphs that worker threads finished rasterizing.
+			See setAsyncRasterization. ColibriManager calls this every frame.
+		@return
+			True if any glyph got its pixels.
+		*/
+		bool processRasterizedGlyphs();
+
+		/// Changes every time processRasterizedGlyphs gives pixels to any glyph. ColibriManagers
+		/// sharing us (see ColibriManager::_setPrimary) compare it to know when to redraw
+		/// their Labels, regardless of which of them processed the glyphs.
+		uint32_t getRasterizedGlyphsGeneration() const { return m_rasterizedGlyphsGeneration; }
+
+		/// Number of times acquireGlyph found the glyph in the cache
+		size_t getNumGlyphCacheHits() const { return m_numCacheHits; }
+		/// Number of times acquireGlyph had to rasterize a glyph
+		size_t getNumGlyphCacheMisses() const { return m_numCacheMisses; }
+		/// Number of unused glyphs that were destroyed, either to make room for
+		/// other glyphs or by flushReleasedGlyphs
+		size_t getNumGlyphEvictions() const { return m_numEvictions; }
+		/// Number of glyphs in the cache that are not in use
+		size_t getNumUnusedGlyphs() const { return m_numUnusedGlyphs; }
+		/// Sets the hit, miss & eviction counters back to 0
+		void resetGlyphCacheStats();
+
 		/**
 		@brief renderString
 		@param utf8Str
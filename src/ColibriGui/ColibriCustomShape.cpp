@@ -9,7 +9,7 @@ CustomShape::CustomShape( ColibriManager *manager ) :
 	Renderable( manager ),
 	m_sizeMode( CustomShapeSizeMode::Ndc )
 {
-	setVao( m_manager->getVao() );
+	setVao( m_manager->_getVertexFormatVao() );
 	setCustomParameter( 6374, Ogre::Vector4( 1.0f ) );
 
 	m_numVertices = 0;
@@ -131,6 +131,13 @@ void CustomShape::setVertex( size_t idx, const Ogre::Vector2 &pos, const Ogre::V
 	m_vertices[idx].rgbaColour[3] = static_cast<uint8_t>( colour.a * 255.0f + 0.5f );
 }
 
+//-------------------------------------------------------------------------
+void CustomShape::_getVertexCountUpperBound( size_t &inOutNumVertices,
+											 size_t &inOutNumTextVertices ) const
+{
+	inOutNumVertices += m_vertices.size();
+	Widget::_getVertexCountUpperBound( inOutNumVertices, inOutNumTextVertices );
+}
 //-------------------------------------------------------------------------
 void CustomShape::_fillBuffersAndCommands(
 	UiVertex *colibri_nonnull *colibri_nonnull RESTRICT_ALIAS _vertexBuffer,
@@ -139,15 +146,10 @@ void CustomShape::_fillBuffersAndCommands(
 {
 	UiVertex *RESTRICT_ALIAS vertexBuffer = *_vertexBuffer;
 
-	updateDerivedTransform( parentPos, parentRot );
-
-	m_culled = true;
-
-	if( !m_parent->intersectsChild( this, parentScrollPos ) || m_hidden )
+	const bool bCulled = !m_parent->intersectsChild( this, parentScrollPos ) || m_hidden;
+	if( setCulledAndUpdateDerivedTransform( bCulled, parentPos, parentRot ) )
 		return;
 
-	m_culled = false;
-
 	Ogre::Vector2 parentDerivedTL;
 	Ogre::Vector2 parentDerivedBR;
 
@@ -165,6 +167,8 @@ void CustomShape::_fillBuffersAndCommands(
 	m_accumMinClipTL = parentDerivedTL;
 	m_accumMaxClipBR = parentDerivedBR;
 
+	updateDrawParams( parentDerivedTL, parentDerivedBR );
+
 	const Ogre::Vector2 widgetOffset =
 		m_sizeMode == CustomShapeSizeMode::Ndc ? Ogre::Vector2::UNIT_SCALE : Ogre::Vector2::ZERO;
 	const Ogre::Vector2 widgetHalfSize =
@@ -181,7 +185,10 @@ void CustomShape::_fillBuffersAndCommands(
 										static_cast<uint8_t>( m_colour.b * 255.0f + 0.5f ),
 										static_cast<uint8_t>( m_colour.a * 255.0f + 0.5f ) };
 
-		const Ogre::Vector2 invSize = 1.0f / ( parentDerivedBR - parentDerivedTL );
+		const Ogre::Vector2 clipRectTL = m_derivedTopLeft;
+		const Ogre::Vector2 clipRectBR = m_derivedTopLeft + getVertexClipRectSize();
+		const Ogre::Vector2 invSize = 1.0f / ( clipRectBR - clipRectTL );
+		const Ogre::Vector2 posOffset( m_drawParams.posOffset[0], m_drawParams.posOffset[1] );
 		const float canvasAspectRatio = m_manager->getCanvasAspectRatio();
 		const float invCanvasAspectRatio = m_manager->getCanvasInvAspectRatio();
 
@@ -196,8 +203,9 @@ void CustomShape::_fillBuffersAndCommands(
 			finalPos = Widget::mul( derivedRot, finalPos.x, finalPos.y * invCanvasAspectRatio );
 			finalPos.y *= canvasAspectRatio;
 
-			vertexBuffer->x = static_cast<float>( finalPos.x );
-			vertexBuffer->y = static_cast<float>( -finalPos.y );
+			// The vertex shader adds posOffset back
+			vertexBuffer->x = static_cast<float>( finalPos.x - posOffset.x );
+			vertexBuffer->y = static_cast<float>( -finalPos.y - posOffset.y );
 
 			vertexBuffer->u = vertex.u;
 			vertexBuffer->v = vertex.v;
@@ -206,18 +214,21 @@ void CustomShape::_fillBuffersAndCommands(
 
 			// Calculate clipping
 			vertexBuffer->clipDistance[Borders::Top] =
-				static_cast<float>( ( finalPos.y - parentDerivedTL.y ) * invSize.y );
+				static_cast<float>( ( finalPos.y - clipRectTL.y ) * invSize.y );
 			vertexBuffer->clipDistance[Borders::Left] =
-				static_cast<float>( ( finalPos.x - parentDerivedTL.x ) * invSize.x );
+				static_cast<float>( ( finalPos.x - clipRectTL.x ) * invSize.x );
 			vertexBuffer->clipDistance[Borders::Right] =
-				static_cast<float>( ( parentDerivedBR.x - finalPos.x ) * invSize.x );
+				static_cast<float>( ( clipRectBR.x - finalPos.x ) * invSize.x );
 			vertexBuffer->clipDistance[Borders::Bottom] =
-				static_cast<float>( ( parentDerivedBR.y - finalPos.y ) * invSize.y );
+				static_cast<float>( ( clipRectBR.y - finalPos.y ) * invSize.y );
 			++vertexBuffer;
 		}
 
 		*_vertexBuffer = vertexBuffer;
 
+		// CustomShape doesn't support retained mode. It always rewrites its vertices.
+		m_manager->_notifyVerticesRewritten( static_cast<uint32_t>( m_vertices.size() ) );
+
 		const Matrix2x3 &finalRot = this->m_derivedOrientation;
 
 		const Ogre::Vector2 currentScrollPos = Ogre::Vector2::ZERO;
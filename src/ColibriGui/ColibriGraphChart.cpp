@@ -32,6 +32,8 @@ GraphChart::Params::Params() :
 GraphChart::GraphChart( ColibriManager *manager ) :
 	CustomShape( manager ),
 	m_textureData( 0 ),
+	m_writeCursor( 0u ),
+	m_numPushedSamples( 0u ),
 	m_labelsDirty( true ),
 	m_autoMin( false ),
 	m_autoMax( false ),
@@ -41,7 +43,8 @@ GraphChart::GraphChart( ColibriManager *manager ) :
 	m_maxSample( 1.0f ),
 	m_lastMinValue( std::numeric_limits<float>::max() ),
 	m_lastMaxValue( -std::numeric_limits<float>::max() ),
-	m_labelPrecision( 2 )
+	m_labelPrecision( 2 ),
+	m_numDatasetsBucket( 0u )
 {
 	setCustomParameter( 6375, Ogre::Vector4( 1.0f ) );
 }
@@ -84,6 +87,7 @@ void GraphChart::_initialize()
 			Ogre::HlmsMacroblock macroblock;
 			macroblock.mDepthCheck = false;
 			macroblock.mDepthWrite = false;
+			macroblock.mScissorTestEnabled = true;  // See HlmsColibri::createDatablockImpl
 			refDatablock->setMacroblock( macroblock );
 		}
 	}
@@ -144,6 +148,11 @@ void GraphChart::setMaxValues( const uint32_t numColumns, const uint32_t maxEntr
 	m_columns.resize( numColumns );
 	m_allValues.clear();
 	m_allValues.resize( numColumns * maxEntriesPerColumn, 0.0f );
+	m_writeCursor = 0u;
+	m_numPushedSamples = 0u;
+	m_windowMin.clear();
+	m_windowMax.clear();
+	updateRingOffset();
 
 	for( size_t y = 0u; y < numColumns; ++y )
 	{
@@ -320,68 +329,138 @@ void GraphChart::positionLabels()
 	m_labelsDirty = false;
 }
 //-------------------------------------------------------------------------
-void GraphChart::syncChart()
+void GraphChart::pushToWindow( const float minValue, const float maxValue )
 {
-	Ogre::TextureGpuManager *textureManager = m_textureData->getTextureManager();
-	Ogre::StagingTexture *stagingTexture = textureManager->getStagingTexture(
-		m_textureData->getWidth(), m_textureData->getHeight(), 1u, 1u, Ogre::PFG_R16_UNORM, 100u );
+	const uint64_t sampleIdx = m_numPushedSamples++;
+
+	while( !m_windowMin.empty() && m_windowMin.back().value >= minValue )
+		m_windowMin.pop_back();
+	while( !m_windowMax.empty() && m_windowMax.back().value <= maxValue )
+		m_windowMax.pop_back();
+
+	WindowSample windowSample;
+	windowSample.sampleIdx = sampleIdx;
+	windowSample.value = minValue;
+	m_windowMin.push_back( windowSample );
+	windowSample.value = maxValue;
+	m_windowMax.push_back( windowSample );
+
+	// Forget the samples that are no longer in Column::values
+	const uint64_t windowSize = getEntriesPerColumn();
+	while( m_windowMin.front().sampleIdx + windowSize <= sampleIdx )
+		m_windowMin.pop_front();
+	while( m_windowMax.front().sampleIdx + windowSize <= sampleIdx )
+		m_windowMax.pop_front();
+}
+//-------------------------------------------------------------------------
+void GraphChart::rebuildWindow()
+{
+	m_windowMin.clear();
+	m_windowMax.clear();
 
-	stagingTexture->startMapRegion();
-	Ogre::TextureBox textureBox = stagingTexture->mapRegion(
-		m_textureData->getWidth(), m_textureData->getHeight(), 1u, 1u, Ogre::PFG_R16_UNORM );
+	const size_t numColumns = m_columns.size();
+	const uint32_t entriesPerColumn = getEntriesPerColumn();
 
-	COLIBRI_ASSERT_MEDIUM( m_textureData->getWidth() == getEntriesPerColumn() );
-	COLIBRI_ASSERT_MEDIUM( m_textureData->getHeight() == m_columns.size() );
+	if( numColumns == 0u )
+		return;
 
+	// Oldest first
+	for( uint32_t i = 0u; i < entriesPerColumn; ++i )
+	{
+		const uint32_t x = ( m_writeCursor + i ) % entriesPerColumn;
+		float minValue = m_columns[0].values[x];
+		float maxValue = minValue;
+		for( size_t y = 1u; y < numColumns; ++y )
+		{
+			minValue = std::min( m_columns[y].values[x], minValue );
+			maxValue = std::max( m_columns[y].values[x], maxValue );
+		}
+		pushToWindow( minValue, maxValue );
+	}
+}
+//-------------------------------------------------------------------------
+void GraphChart::calculateDataRange( float &outMinSample, float &outMaxSample ) const
+{
 	float minSample = m_minSample;
 	float maxSample = m_maxSample;
 
+	const bool autoMin = m_autoMin && !m_windowMin.empty();
+	const bool autoMax = m_autoMax && !m_windowMax.empty();
+
+	if( autoMin || autoMax )
 	{
-		const bool autoMin = m_autoMin;
-		const bool autoMax = m_autoMax;
+		if( autoMin )
+			minSample = std::min( m_windowMin.front().value, minSample );
+		if( autoMax )
+			maxSample = std::max( m_windowMax.front().value, maxSample );
 
-		if( autoMin || autoMax )
+		if( m_autoMinMaxRounding != 0.0f )
 		{
-			for( size_t y = 0u; y < textureBox.height; ++y )
-			{
-				for( size_t x = 0u; x < textureBox.width; ++x )
-				{
-					if( autoMin )
-						minSample = std::min( m_columns[y].values[x], minSample );
-					if( autoMax )
-						maxSample = std::max( m_columns[y].values[x], maxSample );
-				}
-			}
-
-			if( m_autoMinMaxRounding != 0.0f )
-			{
-				if( autoMin )
-					minSample = std::round( minSample / m_autoMinMaxRounding ) * m_autoMinMaxRounding;
-				if( autoMax )
-					maxSample = std::round( maxSample / m_autoMinMaxRounding ) * m_autoMinMaxRounding;
-			}
+			if( autoMin )
+				minSample = std::round( minSample / m_autoMinMaxRounding ) * m_autoMinMaxRounding;
+			if( autoMax )
+				maxSample = std::round( maxSample / m_autoMinMaxRounding ) * m_autoMinMaxRounding;
 		}
 	}
 
+	outMinSample = minSample;
+	outMaxSample = maxSample;
+}
+//-------------------------------------------------------------------------
+void GraphChart::uploadEntries( const uint32_t firstEntry, const uint32_t numEntries,
+								const float minSample, const float maxSample )
+{
+	COLIBRI_ASSERT_MEDIUM( m_textureData->getWidth() == getEntriesPerColumn() );
+	COLIBRI_ASSERT_MEDIUM( m_textureData->getHeight() == m_columns.size() );
+	COLIBRI_ASSERT_LOW( firstEntry + numEntries <= m_textureData->getWidth() );
+
+	const uint32_t numColumns = m_textureData->getHeight();
+
+	Ogre::TextureGpuManager *textureManager = m_textureData->getTextureManager();
+	Ogre::StagingTexture *stagingTexture = textureManager->getStagingTexture(
+		numEntries, numColumns, 1u, 1u, Ogre::PFG_R16_UNORM, 100u );
+
+	stagingTexture->startMapRegion();
+	Ogre::TextureBox textureBox =
+		stagingTexture->mapRegion( numEntries, numColumns, 1u, 1u, Ogre::PFG_R16_UNORM );
+
 	const float sampleInterval =
 		( maxSample - minSample ) < 1e-6f ? 1.0f : ( 1.0f / ( maxSample - minSample ) );
 
 	for( size_t y = 0u; y < textureBox.height; ++y )
 	{
+		const float *RESTRICT_ALIAS srcData = m_columns[y].values + firstEntry;
 		uint16_t *RESTRICT_ALIAS dstData =
 			reinterpret_cast<uint16_t * RESTRICT_ALIAS>( textureBox.at( 0u, y, 0u ) );
 		for( size_t x = 0u; x < textureBox.width; ++x )
 		{
-			float fValue =
-				Ogre::Math::saturate( ( m_columns[y].values[x] - minSample ) * sampleInterval );
+			float fValue = Ogre::Math::saturate( ( srcData[x] - minSample ) * sampleInterval );
 			dstData[x] = static_cast<uint16_t>( fValue * 65535.0f );
 		}
 	}
 
 	stagingTexture->stopMapRegion();
-	stagingTexture->upload( textureBox, m_textureData, 0u );
+
+	Ogre::TextureBox dstBox = m_textureData->getEmptyBox( 0u );
+	dstBox.x = firstEntry;
+	dstBox.width = numEntries;
+	stagingTexture->upload( textureBox, m_textureData, 0u, 0, &dstBox );
 	textureManager->removeStagingTexture( stagingTexture );
 
+	// Our vertices didn't change, but what we look like did
+	m_manager->_notifyDirtyRegion( this );
+}
+//-------------------------------------------------------------------------
+void GraphChart::syncChart()
+{
+	if( m_autoMin || m_autoMax )
+		rebuildWindow();
+
+	float minSample, maxSample;
+	calculateDataRange( minSample, maxSample );
+
+	uploadEntries( 0u, getEntriesPerColumn(), minSample, maxSample );
+
 #if OGRE_VERSION >= OGRE_MAKE_VERSION( 2, 3, 0 )
 	// Workaround OgreNext bug where calling syncChart() multiple times in a row causes Vulkan
 	// race conditions because it doesn't place barriers to protect each copy as it assumes
@@ -399,6 +478,53 @@ void GraphChart::syncChart()
 	positionLabels();
 }
 //-------------------------------------------------------------------------
+void GraphChart::pushSamples( const float *samples, const uint32_t numSamples )
+{
+	const uint32_t entriesPerColumn = getEntriesPerColumn();
+	const size_t numColumns = m_columns.size();
+
+	if( numSamples == 0u || entriesPerColumn == 0u || numColumns == 0u )
+		return;
+
+	const uint32_t firstEntry = m_writeCursor;
+
+	for( uint32_t i = 0u; i < numSamples; ++i )
+	{
+		const float *rowSamples = samples + i * numColumns;
+		float minValue = rowSamples[0];
+		float maxValue = minValue;
+		for( size_t y = 0u; y < numColumns; ++y )
+		{
+			m_columns[y].values[m_writeCursor] = rowSamples[y];
+			minValue = std::min( rowSamples[y], minValue );
+			maxValue = std::max( rowSamples[y], maxValue );
+		}
+		pushToWindow( minValue, maxValue );
+		m_writeCursor = ( m_writeCursor + 1u ) % entriesPerColumn;
+	}
+
+	updateRingOffset();
+
+	float minSample, maxSample;
+	calculateDataRange( minSample, maxSample );
+
+	if( numSamples >= entriesPerColumn || m_lastMinValue != minSample ||
+		m_lastMaxValue != maxSample )
+	{
+		// All the samples need to be normalized again (or all of them are new anyway)
+		syncChart();
+		return;
+	}
+
+	// Upload only the new samples. They're contiguous unless they wrapped around
+	const uint32_t numEntriesToEnd = std::min( numSamples, entriesPerColumn - firstEntry );
+	uploadEntries( firstEntry, numEntriesToEnd, minSample, maxSample );
+	if( numEntriesToEnd < numSamples )
+		uploadEntries( 0u, numSamples - numEntriesToEnd, minSample, maxSample );
+
+	positionLabels();
+}
+//-------------------------------------------------------------------------
 void GraphChart::setMarkersFontSize( FontSize fontSize )
 {
 	for( Colibri::Label *label : m_markers )
@@ -406,6 +532,67 @@ void GraphChart::setMarkersFontSize( FontSize fontSize )
 	m_labelsDirty = true;
 }
 //-------------------------------------------------------------------------
+static uint32_t packColour( const Ogre::ColourValue &colour )
+{
+	uint32_t retVal = 0u;
+	for( size_t i = 0u; i < 4u; ++i )
+	{
+		const float fValue = Ogre::Math::saturate( colour[i] ) * 255.0f + 0.5f;
+		retVal |= static_cast<uint32_t>( fValue ) << ( i * 8u );
+	}
+	return retVal;
+}
+//-------------------------------------------------------------------------
+void GraphChart::fillGraphDrawParams()
+{
+	const size_t numDatasets = m_columns.size();
+	// Above c_maxDatasets the dataset colours are baked into the shader instead
+	const size_t numDatasetVec4s = numDatasets <= c_maxDatasets ? ( numDatasets + 3u ) / 4u : 0u;
+	m_graphDrawParams.clear();
+	m_graphDrawParams.resize( ( 3u + numDatasetVec4s ) * 4u, 0u );
+
+	const float intervalLength = 1.0f / float( m_params.numLines - 1u );
+	const Ogre::Vector2 graphEndBR = m_params.graphInnerTopLeft + m_params.graphInnerSize;
+
+	const float floatParams[8] = {
+		m_params.graphInnerTopLeft.x,
+		m_params.graphInnerTopLeft.y,
+		graphEndBR.x,
+		graphEndBR.y,
+		intervalLength,
+		intervalLength - m_params.lineThickness,
+		static_cast<float>( numDatasets ),
+		0.0f,
+	};
+	memcpy( &m_graphDrawParams[0], floatParams, sizeof( floatParams ) );
+
+	updateRingOffset();
+
+	m_graphDrawParams[8u] = packColour( m_params.lineColour );
+	m_graphDrawParams[9u] = packColour( m_params.bgInnerColour );
+	m_graphDrawParams[10u] = packColour( m_params.bgOuterColour );
+
+	if( numDatasetVec4s != 0u )
+	{
+		for( size_t i = 0u; i < numDatasets; ++i )
+			m_graphDrawParams[12u + i] = packColour( m_columns[i].rectangle->getColour() );
+	}
+
+	setExtraDrawParams( &m_graphDrawParams[0],
+						static_cast<uint32_t>( m_graphDrawParams.size() / 4u ) );
+}
+//-------------------------------------------------------------------------
+void GraphChart::updateRingOffset()
+{
+	if( m_graphDrawParams.empty() )
+		return;  // Not built yet. fillGraphDrawParams will call us
+
+	const uint32_t entriesPerColumn = getEntriesPerColumn();
+	const float ringOffset =
+		entriesPerColumn ? float( m_writeCursor ) / float( entriesPerColumn ) : 0.0f;
+	memcpy( &m_graphDrawParams[7u], &ringOffset, sizeof( ringOffset ) );
+}
+//-------------------------------------------------------------------------
 void GraphChart::build( const Params &params )
 {
 	m_params = params;
@@ -425,9 +612,19 @@ void GraphChart::build( const Params &params )
 	for( size_t i = oldNumLabels; i < newNumLabels; ++i )
 		m_markers[i] = m_manager->createWidget<Colibri::Label>( this );
 
-	Ogre::HlmsDatablock *datablock = mHlmsDatablock;
-	_setNullDatablock();
-	setDatablock( datablock );
+	fillGraphDrawParams();
+
+	// Only the number of datasets (rounded up) is baked into the shader. Above
+	// c_maxDatasets their colours are baked too, so the shader must always be rebuilt
+	const size_t numDatasets = m_columns.size();
+	const uint32_t numDatasetsBucket = static_cast<uint32_t>( ( numDatasets + 3u ) & ~size_t( 3u ) );
+	if( m_numDatasetsBucket != numDatasetsBucket || numDatasets > c_maxDatasets )
+	{
+		m_numDatasetsBucket = numDatasetsBucket;
+		Ogre::HlmsDatablock *datablock = mHlmsDatablock;
+		_setNullDatablock();
+		setDatablock( datablock );
+	}
 
 	m_labelsDirty = true;
 	syncChart();
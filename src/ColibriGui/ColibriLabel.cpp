@@ -36,6 +36,7 @@ namespace Colibri
 	Label::Label( ColibriManager *manager ) :
 		Renderable( manager ),
 		m_usesBackground( false ),
+		m_glyphsPending( false ),
 		m_clipTextToWidget( true ),
 		m_shadowOutline( false ),
 		m_shadowColour( Ogre::ColourValue::Black ),
@@ -54,7 +55,7 @@ namespace Colibri
 		m_rasterPrivateArea( 0 )
 	{
 		m_overrideSkinColour = true;
-		setVao( m_manager->getTextVao() );
+		setVao( m_manager->_getTextVertexFormatVao() );
 
 		ShaperManager *shaperManager = m_manager->getShaperManager();
 		for( size_t i = 0; i < States::NumStates; ++i )
@@ -230,6 +231,7 @@ namespace Colibri
 		m_shadowOutline = enable;
 		m_shadowColour = shadowColour;
 		m_shadowDisplace = shadowDisplace;
+		setVisualsDirty();
 	}
 	//-------------------------------------------------------------------------
 	void Label::setDefaultFontSize( FontSize defaultFontSize )
@@ -275,6 +277,7 @@ namespace Colibri
 							   States::States forState )
 	{
 		m_defaultColour = colour;
+		setVisualsDirty();
 		if( forState == States::NumStates )
 		{
 			for( size_t i = 0; i < States::NumStates; ++i )
@@ -513,6 +516,18 @@ namespace Colibri
 				m_actualVertReadingDir[state] = m_vertReadingDir;
 		}
 
+		if( shaperManager->getAsyncRasterizationThreads() > 0u && !m_glyphsPending )
+		{
+			ShapedGlyphVec::const_iterator itor = m_shapes[state].begin();
+			ShapedGlyphVec::const_iterator end = m_shapes[state].end();
+
+			while( itor != end && !m_glyphsPending )
+			{
+				m_glyphsPending = itor->glyph->pendingRaster;
+				++itor;
+			}
+		}
+
 		m_glyphsDirty[state] = false;
 
 		if( bPlaceGlyphs && !m_glyphsPlaced[state] )
@@ -525,6 +540,8 @@ namespace Colibri
 	//-------------------------------------------------------------------------
 	void Label::placeGlyphs( States::States state, bool performAlignment )
 	{
+		setVisualsDirty();
+
 		const Ogre::Vector2 bottomRight =
 			m_size * ( 2.0f * m_manager->getHalfWindowResolution() / m_manager->getCanvasSize() );
 
@@ -925,6 +942,7 @@ namespace Colibri
 	{
 		TODO_this_is_a_workaround_neg_y;
 		Ogre::Vector2 tmp2d;
+		const uint16_t drawSlot = m_textDrawSlot;
 
 #define COLIBRI_ADD_VERTEX( _x, _y, _u, _v, clipDistanceTop, clipDistanceLeft, clipDistanceRight, \
 							clipDistanceBottom ) \
@@ -934,6 +952,8 @@ namespace Colibri
 	vertexBuffer->y = -tmp2d.y; \
 	vertexBuffer->width = glyphWidth; \
 	vertexBuffer->height = glyphHeight; \
+	vertexBuffer->drawSlot = drawSlot; \
+	vertexBuffer->unused = 0u; \
 	vertexBuffer->offset = offset; \
 	vertexBuffer->rgbaColour = rgbaColour; \
 	vertexBuffer->clipDistance[Borders::Top] = clipDistanceTop; \
@@ -958,23 +978,12 @@ namespace Colibri
 							( parentDerivedBR.x - bottomRight.x ) * invSize.x,
 							( parentDerivedBR.y - bottomRight.y ) * invSize.y );
 
-		COLIBRI_ADD_VERTEX( bottomRight.x, bottomRight.y, glyphWidth, glyphHeight,
-							( bottomRight.y - parentDerivedTL.y ) * invSize.y,
-							( bottomRight.x - parentDerivedTL.x ) * invSize.x,
-							( parentDerivedBR.x - bottomRight.x ) * invSize.x,
-							( parentDerivedBR.y - bottomRight.y ) * invSize.y );
-
 		COLIBRI_ADD_VERTEX( bottomRight.x, topLeft.y, glyphWidth, 0u,
 							( topLeft.y - parentDerivedTL.y ) * invSize.y,
 							( bottomRight.x - parentDerivedTL.x ) * invSize.x,
 							( parentDerivedBR.x - bottomRight.x ) * invSize.x,
 							( parentDerivedBR.y - topLeft.y ) * invSize.y );
 
-		COLIBRI_ADD_VERTEX( topLeft.x, topLeft.y, 0u, 0u, ( topLeft.y - parentDerivedTL.y ) * invSize.y,
-							( topLeft.x - parentDerivedTL.x ) * invSize.x,
-							( parentDerivedBR.x - topLeft.x ) * invSize.x,
-							( parentDerivedBR.y - topLeft.y ) * invSize.y );
-
 #undef COLIBRI_ADD_VERTEX
 	}
 	//-------------------------------------------------------------------------
@@ -1076,7 +1085,8 @@ namespace Colibri
 										const Ogre::Vector2 halfWindowRes,
 										const Ogre::Vector2 invWindowRes,
 										const Ogre::Vector2 parentDerivedTL,
-										const Ogre::Vector2 parentDerivedBR, const bool isHorizontal )
+										const Ogre::Vector2 parentDerivedBR, const bool isHorizontal,
+										const uint32_t maxVertices )
 	{
 		const Ogre::Vector2 invSize = 1.0f / ( parentDerivedBR - parentDerivedTL );
 
@@ -1087,7 +1097,7 @@ namespace Colibri
 		derivedTopLeft.y = roundf( derivedTopLeft.y );
 		derivedTopLeft = derivedTopLeft * invWindowRes - 1.0f;
 
-		const Matrix2x3 derivedRot = m_derivedOrientation;
+		const Matrix2x3 derivedRot = getVertexOrientation();
 		const float canvasAr = m_manager->getCanvasAspectRatio();
 		const float invCanvasAr = m_manager->getCanvasInvAspectRatio();
 
@@ -1154,6 +1164,12 @@ namespace Colibri
 
 					if( itor + 1u == end || changesLine )
 					{
+						if( colibri_unlikely( m_numVertices + c_numGlyphVertices > maxVertices ) )
+						{
+							COLIBRI_ASSERT_LOW( false && "Label background exceeds its upper bound" );
+							return textVertBuffer;
+						}
+
 						const float regionUp = isHorizontal ? shapedGlyph.glyph->regionUp : 0.0f;
 
 						// New line found. Render the background and reset the counters
@@ -1179,8 +1195,8 @@ namespace Colibri
 								 backgroundColour, parentDerivedTL, parentDerivedBR, invSize,  //
 								 0,                                                            //
 								 canvasAr, invCanvasAr, derivedRot );
-						textVertBuffer += 6u;
-						m_numVertices += 6u;
+						textVertBuffer += c_numGlyphVertices;
+						m_numVertices += c_numGlyphVertices;
 
 						Ogre::Vector2 nextCaret = shapedGlyph.caretPos;
 						if( shapedGlyph.isNewline && itor + 1u != end )
@@ -1212,6 +1228,13 @@ namespace Colibri
 		return textVertBuffer;
 	}
 	//-------------------------------------------------------------------------
+	void Label::_getVertexCountUpperBound( size_t &inOutNumVertices,
+										   size_t &inOutNumTextVertices ) const
+	{
+		inOutNumTextVertices += getMaxNumGlyphs() * c_numGlyphVertices;
+		Widget::_getVertexCountUpperBound( inOutNumVertices, inOutNumTextVertices );
+	}
+	//-------------------------------------------------------------------------
 	void Label::_fillBuffersAndCommands( UiVertex **RESTRICT_ALIAS vertexBuffer,
 										 GlyphVertex **RESTRICT_ALIAS _textVertBuffer,
 										 const Ogre::Vector2 &parentPos,
@@ -1220,29 +1243,22 @@ namespace Colibri
 	{
 		GlyphVertex *RESTRICT_ALIAS textVertBuffer = *_textVertBuffer;
 
-		updateDerivedTransform( parentPos, parentRot );
-
-		m_culled = true;
-
-		m_numVertices = 0;
-		if( !m_parent->intersectsChild( this, parentCurrentScrollPos ) || m_hidden )
+		const bool bCulled = !m_parent->intersectsChild( this, parentCurrentScrollPos ) || m_hidden;
+		if( setCulledAndUpdateDerivedTransform( bCulled, parentPos, parentRot ) )
+		{
+			m_numVertices = 0;
 			return;
-
-		m_culled = false;
+		}
 
 		if( !m_visualsEnabled )
+		{
+			m_numVertices = 0;
 			return;
+		}
 
-		m_currVertexBufferOffset =
+		const uint32_t vertexBufferOffset =
 			static_cast<uint32_t>( textVertBuffer - m_manager->_getTextVertexBufferBase() );
 
-		const uint32_t shadowColour = ( m_shadowColour * m_colour ).getAsABGR();
-
-		const Ogre::Vector2 halfWindowRes = m_manager->getHalfWindowResolution();
-		const Ogre::Vector2 invWindowRes = m_manager->getInvWindowResolution2x();
-
-		const Ogre::Vector2 shadowDisplacement = invWindowRes * m_shadowDisplace;
-
 		Ogre::Vector2 invCanvasSize2x = m_manager->getInvCanvasSize2x();
 		Ogre::Vector2 parentDerivedTL =
 			m_parent->m_derivedTopLeft + m_parent->m_clipBorderTL * invCanvasSize2x;
@@ -1258,87 +1274,123 @@ namespace Colibri
 			parentDerivedBR.makeFloor( this->m_derivedBottomRight );
 		}
 
-		const Ogre::Vector2 invSize = 1.0f / ( parentDerivedBR - parentDerivedTL );
+		updateDrawParams( parentDerivedTL, parentDerivedBR, true );
 
-		if( m_usesBackground )
+		if( !beginVisualsUpdate( vertexBufferOffset ) )
 		{
-			const bool isHoriz = m_actualVertReadingDir[m_currentState] == VertReadingDir::Disabled;
-			textVertBuffer = fillBackground( textVertBuffer, halfWindowRes, invWindowRes,
-											 parentDerivedTL, parentDerivedBR, isHoriz );
+			// Retained mode: Vertices from previous frames are still valid.
+			textVertBuffer += m_numVertices;
 		}
+		else
+		{
+			m_numVertices = 0;
+			m_textDrawSlot = m_nextTextDrawSlot;
 
-		// Snap position to pixels
-		Ogre::Vector2 derivedTopLeft = m_derivedTopLeft;
-		derivedTopLeft = ( derivedTopLeft + 1.0f ) * halfWindowRes;
-		derivedTopLeft.x = roundf( derivedTopLeft.x );
-		derivedTopLeft.y = roundf( derivedTopLeft.y );
-		derivedTopLeft = derivedTopLeft * invWindowRes - 1.0f;
+			// Never write more than what _getVertexCountUpperBound reserved. When filling
+			// in parallel, the vertices of the next Window start right after ours.
+			const uint32_t maxVertices =
+				static_cast<uint32_t>( getMaxNumGlyphs() * c_numGlyphVertices );
+			const uint32_t verticesPerGlyph = ( m_shadowOutline ? 2u : 1u ) * c_numGlyphVertices;
 
-		const Matrix2x3 derivedRot = m_derivedOrientation;
-		const float canvasAr = m_manager->getCanvasAspectRatio();
-		const float invCanvasAr = m_manager->getCanvasInvAspectRatio();
+			const uint32_t shadowColour = ( m_shadowColour * m_colour ).getAsABGR();
 
-		const uint8_t colourRgba8[4] = { static_cast<uint8_t>( m_colour.r * 255.0f ),
-										 static_cast<uint8_t>( m_colour.g * 255.0f ),
-										 static_cast<uint8_t>( m_colour.b * 255.0f ),
-										 static_cast<uint8_t>( m_colour.a * 255.0f ) };
+			const Ogre::Vector2 halfWindowRes = m_manager->getHalfWindowResolution();
+			const Ogre::Vector2 invWindowRes = m_manager->getInvWindowResolution2x();
 
-		ShapedGlyphVec::const_iterator itor = m_shapes[m_currentState].begin();
-		ShapedGlyphVec::const_iterator endt = m_shapes[m_currentState].end();
+			const Ogre::Vector2 shadowDisplacement = invWindowRes * m_shadowDisplace;
 
-		while( itor != endt )
-		{
-			const ShapedGlyph &shapedGlyph = *itor;
+			const Ogre::Vector2 clipRectTL = m_derivedTopLeft;
+			const Ogre::Vector2 clipRectBR = m_derivedTopLeft + getVertexClipRectSize();
+			const Ogre::Vector2 invSize = 1.0f / ( clipRectBR - clipRectTL );
 
-			if( !shapedGlyph.isNewline && !shapedGlyph.isTab && !shapedGlyph.isPrivateArea )
+			if( m_usesBackground )
 			{
-				Ogre::Vector2 topLeft, bottomRight;
-				getCorners( shapedGlyph, topLeft, bottomRight );
+				const bool isHoriz = m_actualVertReadingDir[m_currentState] == VertReadingDir::Disabled;
+				textVertBuffer = fillBackground( textVertBuffer, halfWindowRes, invWindowRes,
+												 clipRectTL, clipRectBR, isHoriz, maxVertices );
+			}
+
+			// Snap position to pixels
+			Ogre::Vector2 derivedTopLeft = m_derivedTopLeft;
+			derivedTopLeft = ( derivedTopLeft + 1.0f ) * halfWindowRes;
+			derivedTopLeft.x = roundf( derivedTopLeft.x );
+			derivedTopLeft.y = roundf( derivedTopLeft.y );
+			derivedTopLeft = derivedTopLeft * invWindowRes - 1.0f;
 
-				const Ogre::Vector2 glyphSize = bottomRight - topLeft;
+			const Matrix2x3 derivedRot = getVertexOrientation();
+			const float canvasAr = m_manager->getCanvasAspectRatio();
+			const float invCanvasAr = m_manager->getCanvasInvAspectRatio();
 
-				// Snap each glyph to pixels too
-				topLeft.x = roundf( topLeft.x );
-				topLeft.y = roundf( topLeft.y );
-				bottomRight = topLeft + glyphSize;
+			const uint8_t colourRgba8[4] = { static_cast<uint8_t>( m_colour.r * 255.0f ),
+											 static_cast<uint8_t>( m_colour.g * 255.0f ),
+											 static_cast<uint8_t>( m_colour.b * 255.0f ),
+											 static_cast<uint8_t>( m_colour.a * 255.0f ) };
 
-				topLeft = derivedTopLeft + topLeft * invWindowRes;
-				bottomRight = derivedTopLeft + bottomRight * invWindowRes;
+			ShapedGlyphVec::const_iterator itor = m_shapes[m_currentState].begin();
+			ShapedGlyphVec::const_iterator endt = m_shapes[m_currentState].end();
 
-				if( m_shadowOutline )
+			while( itor != endt )
+			{
+				const ShapedGlyph &shapedGlyph = *itor;
+
+				if( !shapedGlyph.isNewline && !shapedGlyph.isTab && !shapedGlyph.isPrivateArea )
 				{
-					addQuad( textVertBuffer,                                           //
-							 topLeft + shadowDisplacement,                             //
-							 bottomRight + shadowDisplacement,                         //
-							 shapedGlyph.glyph->width, shapedGlyph.glyph->height,      //
-							 shadowColour, parentDerivedTL, parentDerivedBR, invSize,  //
-							 shapedGlyph.glyph->offsetStart,                           //
-							 canvasAr, invCanvasAr, derivedRot );
-					textVertBuffer += 6u;
-					m_numVertices += 6u;
-				}
+					if( colibri_unlikely( m_numVertices + verticesPerGlyph > maxVertices ) )
+					{
+						COLIBRI_ASSERT_LOW( false && "Label glyphs exceed their upper bound" );
+						break;
+					}
 
-				const RichText &richText = m_richText[m_currentState][shapedGlyph.richTextIdx];
+					Ogre::Vector2 topLeft, bottomRight;
+					getCorners( shapedGlyph, topLeft, bottomRight );
 
-				const uint32_t oldRgba32 = richText.rgba32;
-				uint32_t newRgba32 = 0u;
+					const Ogre::Vector2 glyphSize = bottomRight - topLeft;
 
-				newRgba32 |= ( ( oldRgba32 & 0xFFu ) * colourRgba8[0] ) / 255u;
-				newRgba32 |= ( ( ( ( oldRgba32 >> 8u ) & 0xFFu ) * colourRgba8[1] ) / 255u ) << 8u;
-				newRgba32 |= ( ( ( ( oldRgba32 >> 16u ) & 0xFFu ) * colourRgba8[2] ) / 255u ) << 16u;
-				newRgba32 |= ( ( ( ( oldRgba32 >> 24u ) & 0xFFu ) * colourRgba8[3] ) / 255u ) << 24u;
+					// Snap each glyph to pixels too
+					topLeft.x = roundf( topLeft.x );
+					topLeft.y = roundf( topLeft.y );
+					bottomRight = topLeft + glyphSize;
 
-				addQuad( textVertBuffer, topLeft, bottomRight,                  //
-						 shapedGlyph.glyph->width, shapedGlyph.glyph->height,   //
-						 newRgba32, parentDerivedTL, parentDerivedBR, invSize,  //
-						 shapedGlyph.glyph->offsetStart,                        //
-						 canvasAr, invCanvasAr, derivedRot );
-				textVertBuffer += 6u;
+					topLeft = derivedTopLeft + topLeft * invWindowRes;
+					bottomRight = derivedTopLeft + bottomRight * invWindowRes;
 
-				m_numVertices += 6u;
+					if( m_shadowOutline )
+					{
+						addQuad( textVertBuffer,                                           //
+								 topLeft + shadowDisplacement,                             //
+								 bottomRight + shadowDisplacement,                         //
+								 shapedGlyph.glyph->width, shapedGlyph.glyph->height,      //
+								 shadowColour, clipRectTL, clipRectBR, invSize,            //
+								 shapedGlyph.glyph->offsetStart,                           //
+								 canvasAr, invCanvasAr, derivedRot );
+						textVertBuffer += c_numGlyphVertices;
+						m_numVertices += c_numGlyphVertices;
+					}
+
+					const RichText &richText = m_richText[m_currentState][shapedGlyph.richTextIdx];
+
+					const uint32_t oldRgba32 = richText.rgba32;
+					uint32_t newRgba32 = 0u;
+
+					newRgba32 |= ( ( oldRgba32 & 0xFFu ) * colourRgba8[0] ) / 255u;
+					newRgba32 |= ( ( ( ( oldRgba32 >> 8u ) & 0xFFu ) * colourRgba8[1] ) / 255u ) << 8u;
+					newRgba32 |= ( ( ( ( oldRgba32 >> 16u ) & 0xFFu ) * colourRgba8[2] ) / 255u ) << 16u;
+					newRgba32 |= ( ( ( ( oldRgba32 >> 24u ) & 0xFFu ) * colourRgba8[3] ) / 255u ) << 24u;
+
+					addQuad( textVertBuffer, topLeft, bottomRight,                  //
+							 shapedGlyph.glyph->width, shapedGlyph.glyph->height,   //
+							 newRgba32, clipRectTL, clipRectBR, invSize,            //
+							 shapedGlyph.glyph->offsetStart,                        //
+							 canvasAr, invCanvasAr, derivedRot );
+					textVertBuffer += c_numGlyphVertices;
+
+					m_numVertices += c_numGlyphVertices;
+				}
+
+				++itor;
 			}
 
-			++itor;
+			m_manager->_notifyTextVerticesRewritten( m_numVertices );
 		}
 
 		*_textVertBuffer = textVertBuffer;
@@ -1371,6 +1423,28 @@ namespace Colibri
 		}
 	}
 	//-------------------------------------------------------------------------
+	void Label::_notifyGlyphsRasterized()
+	{
+		if( !m_glyphsPending )
+			return;
+
+		m_glyphsPending = false;
+		for( size_t i = 0; i < States::NumStates && !m_glyphsPending; ++i )
+		{
+			ShapedGlyphVec::const_iterator itor = m_shapes[i].begin();
+			ShapedGlyphVec::const_iterator end = m_shapes[i].end();
+
+			while( itor != end && !m_glyphsPending )
+			{
+				m_glyphsPending = itor->glyph->pendingRaster;
+				++itor;
+			}
+		}
+
+		// The vertices are the same, but the pixels they point to changed
+		setVisualsDirty();
+	}
+	//-------------------------------------------------------------------------
 	bool Label::isAnyStateDirty() const
 	{
 		bool retVal = false;
@@ -1386,6 +1460,7 @@ namespace Colibri
 			m_manager->_addDirtyLabel( this );
 		m_glyphsDirty[state] = true;
 		m_glyphsPlaced[state] = false;
+		setVisualsDirty();
 #if COLIBRIGUI_DEBUG >= COLIBRIGUI_DEBUG_MEDIUM
 		m_glyphsAligned[state] = false;
 #endif
@@ -1712,6 +1787,7 @@ namespace Colibri
 		}
 
 		m_minSize = m_size;
+		m_parent->invalidateHitTestGrid();
 
 		if( m_rasterPrivateArea )
 		{
@@ -26,7 +26,10 @@ namespace Colibri
 		m_fontSize( m_manager->getDefaultFontSize26d6() ),
 		m_font( 0 )
 	{
-		setVao( m_manager->getVao() );
+		setVao( m_manager->_getVertexFormatVao() );
+		// Glyphs are not 9-slices, thus the shader must not derive the material from the
+		// vertex ID. Same as CustomShape.
+		setCustomParameter( 6374, Ogre::Vector4( 1.0f ) );
 
 		m_numVertices = 0;
 
@@ -93,6 +96,13 @@ namespace Colibri
 			m_manager->_notifyNumGlyphsBmpIsDirty();
 	}
 	//-------------------------------------------------------------------------
+	void LabelBmp::_getVertexCountUpperBound( size_t &inOutNumVertices,
+											  size_t &inOutNumTextVertices ) const
+	{
+		inOutNumVertices += getMaxNumGlyphs() * 6u;
+		Widget::_getVertexCountUpperBound( inOutNumVertices, inOutNumTextVertices );
+	}
+	//-------------------------------------------------------------------------
 	void LabelBmp::_fillBuffersAndCommands( UiVertex **RESTRICT_ALIAS _vertexBuffer,
 											GlyphVertex **RESTRICT_ALIAS _textVertBuffer,
 											const Ogre::Vector2 &parentPos,
@@ -101,15 +111,11 @@ namespace Colibri
 	{
 		UiVertex *RESTRICT_ALIAS vertexBuffer = *_vertexBuffer;
 
-		updateDerivedTransform( parentPos, parentRot );
-
-		m_culled = true;
-
 		m_numVertices = 0;
-		if( !m_parent->intersectsChild( this, parentCurrentScrollPos ) || m_hidden )
-			return;
 
-		m_culled = false;
+		const bool bCulled = !m_parent->intersectsChild( this, parentCurrentScrollPos ) || m_hidden;
+		if( setCulledAndUpdateDerivedTransform( bCulled, parentPos, parentRot ) )
+			return;
 
 		if( !m_visualsEnabled )
 			return;
@@ -149,7 +155,11 @@ namespace Colibri
 			parentDerivedBR.makeFloor( this->m_derivedBottomRight );
 		}
 
-		const Ogre::Vector2 invSize = 1.0f / ( parentDerivedBR - parentDerivedTL );
+		updateDrawParams( parentDerivedTL, parentDerivedBR, true );
+
+		const Ogre::Vector2 clipRectTL = m_derivedTopLeft;
+		const Ogre::Vector2 clipRectBR = m_derivedTopLeft + getVertexClipRectSize();
+		const Ogre::Vector2 invSize = 1.0f / ( clipRectBR - clipRectTL );
 
 		// Snap position to pixels
 		Ogre::Vector2 derivedTopLeft = m_derivedTopLeft;
@@ -158,7 +168,7 @@ namespace Colibri
 		derivedTopLeft.y = roundf( derivedTopLeft.y );
 		derivedTopLeft = derivedTopLeft * invWindowRes - 1.0f;
 
-		const Matrix2x3 derivedRot = m_derivedOrientation;
+		const Matrix2x3 derivedRot = getVertexOrientation();
 		const float canvasAr = m_manager->getCanvasAspectRatio();
 		const float invCanvasAr = m_manager->getCanvasInvAspectRatio();
 
@@ -208,7 +218,7 @@ namespace Colibri
 											  bmpGlyph.bmpChar->y + bmpGlyph.bmpChar->height ) +
 							   0.5f ) *
 								 texInvResolution,
-							 shadowColour, parentDerivedTL, parentDerivedBR, invSize,  //
+							 shadowColour, clipRectTL, clipRectBR, invSize,  //
 							 canvasAr, invCanvasAr, derivedRot );
 					vertexBuffer += 6u;
 					m_numVertices += 6u;
@@ -220,7 +230,7 @@ namespace Colibri
 										  bmpGlyph.bmpChar->y + bmpGlyph.bmpChar->height ) +
 						   0.5f ) *
 							 texInvResolution,
-						 rgbaColour, parentDerivedTL, parentDerivedBR, invSize,  //
+						 rgbaColour, clipRectTL, clipRectBR, invSize,  //
 						 canvasAr, invCanvasAr, derivedRot );
 				vertexBuffer += 6u;
 
@@ -252,6 +262,9 @@ namespace Colibri
 
 		*_vertexBuffer = vertexBuffer;
 
+		// LabelBmp doesn't support retained mode. It always rewrites its vertices.
+		m_manager->_notifyVerticesRewritten( m_numVertices );
+
 		const Ogre::Vector2 outerTopLeft = this->m_derivedTopLeft;
 		const Matrix2x3 &finalRot = this->m_derivedOrientation;
 		const Ogre::Vector2 outerTopLeftWithClipping = outerTopLeft + m_clipBorderTL * invCanvasSize2x;
@@ -390,6 +403,7 @@ namespace Colibri
 		m_size.x = std::ceil( m_size.x );
 		m_size.y = std::ceil( m_size.y );
 		m_minSize = m_size;
+		m_parent->invalidateHitTestGrid();
 	}
 	//-------------------------------------------------------------------------
 	void LabelBmp::setState( States::States state, bool smartHighlight )
@@ -30,6 +30,10 @@ namespace Colibri
 											   Ogre::HLMS_CACHE_FLAGS_NONE,
 #endif
 											   Ogre::HlmsPso() );
+	/// Vertex buffers grow in multiples of this many vertices
+	static const uint32_t c_vertexBufferChunkSize = 1024u;
+	/// How many batches back a draw may be moved when using Widget::m_reorderDraws
+	static const size_t c_maxReorderLookback = 32u;
 
 	const std::string ColibriManager::c_defaultTextDatablockNames[States::NumStates] =
 	{
@@ -48,6 +52,7 @@ namespace Colibri
 		m_numTextGlyphs( 0u ),
 		m_numTextGlyphsBmp( 0u ),
 		m_numCustomShapesVertices( 0u ),
+		m_numNineSlicesPerCell( 0u ),
 		m_logListener( &DefaultLogListener ),
 		m_colibriListener( &DefaultColibriListener ),
 		m_delayingDestruction( false ),
@@ -60,12 +65,37 @@ namespace Colibri
 		m_zOrderHasDirtyChildren( false ),
 		m_touchOnlyMode( false ),
 		m_multipass( multipass ),
+		m_multipassRingSize( 0u ),
+		m_multipassPassIdx( 0u ),
+		m_retainedVertexBuffers( false ),
+		m_rewriteAllVertices( true ),
+		m_fillPassIdx( 0u ),
+		m_lastFrameIdxFilled( std::numeric_limits<uint32_t>::max() ),
+		m_numVerticesRewritten( 0u ),
+		m_numTextVerticesRewritten( 0u ),
+		m_numDrawsBeforeReorder( 0u ),
+		m_numDrawsAfterReorder( 0u ),
+		m_autoBreadthFirst( false ),
+		m_numAutoBreadthFirst( 0u ),
+		m_drawListCaching( false ),
+		m_drawListDirty( true ),
+		m_dirtyRegionTracking( false ),
+		m_dirtyRegionFull( true ),
+		m_numStaleDerivedTransforms( 0u ),
+		m_staleDerivedTransformEpoch( 1u ),
+		m_taskDispatcher( 0 ),
 		m_root( 0 ),
 		m_vaoManager( 0 ),
 		m_objectMemoryManager( 0 ),
 		m_sceneManager( 0 ),
 		m_vao( 0 ),
+		m_nineSliceIndexBuffer( 0 ),
 		m_textVao( 0 ),
+		m_glyphIndexBuffer( 0 ),
+		m_vertexFormatVao( 0 ),
+		m_textVertexFormatVao( 0 ),
+		m_pendingFullRewrites( 0u ),
+		m_autoTrimFrames( 0u ),
 		m_currIndirectBuffer( 0 ),
 		m_lastFrameIdxUpdated( 0u ),
 		m_commandBuffer( 0 ),
@@ -89,6 +119,7 @@ namespace Colibri
 		m_defaultArrowSize( 15.0f, 15.0f ),
 		m_skinManager( 0 ),
 		m_shaperManager( 0 ),
+		m_rasterizedGlyphsGeneration( 0u ),
 		m_vertexBufferBase( 0 ),
 		m_textVertexBufferBase( 0 )
 #if COLIBRIGUI_DEBUG >= COLIBRIGUI_DEBUG_MEDIUM
@@ -98,6 +129,10 @@ namespace Colibri
 #endif
 	{
 		memset( m_defaultTextDatablock, 0, sizeof(m_defaultTextDatablock) );
+		memset( m_reservedVertices, 0, sizeof( m_reservedVertices ) );
+		memset( m_requiredVertices, 0, sizeof( m_requiredVertices ) );
+		memset( m_vertexHighWaterMark, 0, sizeof( m_vertexHighWaterMark ) );
+		memset( m_lowUsageFrames, 0, sizeof( m_lowUsageFrames ) );
 		memset( m_defaultSkins, 0, sizeof(m_defaultSkins) );
 
 		setLogListener( logListener );
@@ -143,8 +178,14 @@ namespace Colibri
 		m_sceneManager = primaryManager->m_sceneManager;
 
 		m_objectMemoryManager = primaryManager->m_objectMemoryManager;
-		m_vao = Ogre::ColibriOgreRenderable::createVao( 6u * 9u, m_vaoManager, m_multipass );
-		m_textVao = Ogre::ColibriOgreRenderable::createTextVao( 6u * 16u, m_vaoManager, m_multipass );
+		m_nineSliceIndexBuffer = Ogre::ColibriOgreRenderable::createIndexBuffer( m_vaoManager );
+		m_vao = createVao( c_numNineSliceVertices, false );
+		m_glyphIndexBuffer = Ogre::ColibriOgreRenderable::createGlyphIndexBuffer( m_vaoManager );
+		m_textVao = createVao( c_numGlyphVertices * 16u, true );
+		m_vertexFormatVao = Ogre::ColibriOgreRenderable::createVao(
+			c_numNineSliceVertices, m_vaoManager, true, m_nineSliceIndexBuffer );
+		m_textVertexFormatVao = Ogre::ColibriOgreRenderable::createTextVao(
+			c_numGlyphVertices, m_vaoManager, true, m_glyphIndexBuffer );
 		m_commandBuffer = primaryManager->m_commandBuffer;
 
 		for( size_t i = 0u; i < SkinWidgetTypes::NumSkinWidgetTypes; ++i )
@@ -206,6 +247,26 @@ namespace Colibri
 			Ogre::ColibriOgreRenderable::destroyVao( m_textVao, m_vaoManager );
 			m_textVao = 0;
 		}
+		if( m_vertexFormatVao )
+		{
+			Ogre::ColibriOgreRenderable::destroyVao( m_vertexFormatVao, m_vaoManager );
+			m_vertexFormatVao = 0;
+		}
+		if( m_textVertexFormatVao )
+		{
+			Ogre::ColibriOgreRenderable::destroyVao( m_textVertexFormatVao, m_vaoManager );
+			m_textVertexFormatVao = 0;
+		}
+		if( m_nineSliceIndexBuffer )
+		{
+			m_vaoManager->destroyIndexBuffer( m_nineSliceIndexBuffer );
+			m_nineSliceIndexBuffer = 0;
+		}
+		if( m_glyphIndexBuffer )
+		{
+			m_vaoManager->destroyIndexBuffer( m_glyphIndexBuffer );
+			m_glyphIndexBuffer = 0;
+		}
 		delete m_objectMemoryManager;
 		m_objectMemoryManager = 0;
 
@@ -216,8 +277,15 @@ namespace Colibri
 		if( vaoManager )
 		{
 			m_objectMemoryManager = new Ogre::ObjectMemoryManager();
-			m_vao = Ogre::ColibriOgreRenderable::createVao( 6u * 9u, vaoManager, m_multipass );
-			m_textVao = Ogre::ColibriOgreRenderable::createTextVao( 6u * 16u, vaoManager, m_multipass );
+			m_nineSliceIndexBuffer = Ogre::ColibriOgreRenderable::createIndexBuffer( vaoManager );
+			m_vao = createVao( c_numNineSliceVertices, false );
+			m_glyphIndexBuffer = Ogre::ColibriOgreRenderable::createGlyphIndexBuffer( vaoManager );
+			m_textVao = createVao( c_numGlyphVertices * 16u, true );
+			// These are never mapped, thus use the same settings as the multipass path
+			m_vertexFormatVao = Ogre::ColibriOgreRenderable::createVao(
+				c_numNineSliceVertices, vaoManager, true, m_nineSliceIndexBuffer );
+			m_textVertexFormatVao = Ogre::ColibriOgreRenderable::createTextVao(
+				c_numGlyphVertices, vaoManager, true, m_glyphIndexBuffer );
 			m_commandBuffer = new Ogre::CommandBuffer();
 			m_commandBuffer->setCurrentRenderSystem( m_sceneManager->getDestinationRenderSystem() );
 
@@ -270,7 +338,7 @@ namespace Colibri
 	{
 		const size_t numWidgets = std::max<size_t>( 16u, m_numWidgets );
 		if( m_currIndirectBuffer >= m_indirectBuffer.size() ||
-			( numWidgets * sizeof( Ogre::CbDrawStrip ) >
+			( numWidgets * sizeof( Ogre::CbDrawIndexed ) >
 			  m_indirectBuffer[m_currIndirectBuffer]->getNumElements() ) )
 		{
 			// Erase all indirect buffers from [m_currIndirectBuffer; end)
@@ -290,7 +358,8 @@ namespace Colibri
 			m_indirectBuffer.erase( m_indirectBuffer.begin() + m_currIndirectBuffer, endt );
 
 			// Create new buffer large enough to hold all widgets.
-			const size_t requiredBytes = numWidgets * sizeof( Ogre::CbDrawStrip );
+			// CbDrawIndexed is the biggest of the two draws we issue (CbDrawStrip)
+			const size_t requiredBytes = numWidgets * sizeof( Ogre::CbDrawIndexed );
 			m_indirectBuffer.emplace_back( m_vaoManager->createIndirectBuffer(
 				requiredBytes, Ogre::BT_DYNAMIC_PERSISTENT, 0, false ) );
 		}
@@ -334,6 +403,126 @@ namespace Colibri
 		m_touchOnlyMode = bTouchOnlyMode;
 	}
 	//-------------------------------------------------------------------------
+	void ColibriManager::setRetainedVertexBuffers( bool bRetained )
+	{
+		m_retainedVertexBuffers = bRetained;
+	}
+	//-------------------------------------------------------------------------
+	void ColibriManager::setMultipassRingSize( uint32_t maxPassesPerFrame )
+	{
+		COLIBRI_ASSERT_LOW( ( m_multipass || maxPassesPerFrame == 0u ) &&
+							"The ring can only be used with multipass ColibriManagers" );
+		if( !m_multipass || m_multipassRingSize == maxPassesPerFrame )
+			return;
+
+		uint32_t vertexCount = c_numNineSliceVertices;
+		uint32_t textVertexCount = c_numGlyphVertices * 16u;
+		if( m_vao )
+		{
+			vertexCount = getVerticesPerPass( m_vao->getBaseVertexBuffer() );
+			textVertexCount = getVerticesPerPass( m_textVao->getBaseVertexBuffer() );
+		}
+
+		m_multipassRingSize = maxPassesPerFrame;
+		m_multipassPassIdx = 0u;
+
+		if( m_vao )
+		{
+			Ogre::ColibriOgreRenderable::destroyVao( m_vao, m_vaoManager );
+			Ogre::ColibriOgreRenderable::destroyVao( m_textVao, m_vaoManager );
+			m_vao = createVao( vertexCount, false );
+			m_textVao = createVao( textVertexCount, true );
+			m_pendingFullRewrites = _getVisualsDirtyFrameCount();
+		}
+
+		if( m_multipassRingSize )
+			std::vector<uint8_t>().swap( m_multipassTmpBuffer );
+	}
+	//-------------------------------------------------------------------------
+	void ColibriManager::setAutoBreadthFirst( bool bAutoBreadthFirst )
+	{
+		m_autoBreadthFirst = bAutoBreadthFirst;
+		_notifyDrawListDirty();
+	}
+	//-------------------------------------------------------------------------
+	void ColibriManager::setDrawListCaching( bool bCaching )
+	{
+		m_drawListCaching = bCaching;
+		m_drawList.clear();
+		_notifyDrawListDirty();
+	}
+	//-------------------------------------------------------------------------
+	void ColibriManager::setDirtyRegionTracking( bool bTrack )
+	{
+		m_dirtyRegionTracking = bTrack;
+		m_dirtyRegionFull = true;
+		m_dirtyRegionRenderables.clear();
+	}
+	//-------------------------------------------------------------------------
+	void ColibriManager::addToDirtyRegion( Renderable *renderable )
+	{
+		if( m_dirtyRegionFull )
+			return;
+
+		// Duplicates are harmless, but filter the common case of several setters in a row.
+		// Past a certain point, it's cheaper to just redraw everything.
+		if( m_dirtyRegionRenderables.size() >= m_numWidgets )
+			_notifyDirtyRegionFull();
+		else if( m_dirtyRegionRenderables.empty() || m_dirtyRegionRenderables.back() != renderable )
+			m_dirtyRegionRenderables.push_back( renderable );
+	}
+	//-------------------------------------------------------------------------
+	void ColibriManager::_notifyDirtyRegionFull()
+	{
+		// Also protects us from holding dangling pointers, since destroying widgets calls us
+		m_dirtyRegionFull = true;
+		m_dirtyRegionRenderables.clear();
+	}
+	//-------------------------------------------------------------------------
+	bool ColibriManager::flushDirtyRegion( Ogre::Vector2 &outTopLeft, Ogre::Vector2 &outBottomRight )
+	{
+		if( !m_dirtyRegionTracking || m_dirtyRegionFull )
+		{
+			outTopLeft = -Ogre::Vector2::UNIT_SCALE;
+			outBottomRight = Ogre::Vector2::UNIT_SCALE;
+			m_dirtyRegionFull = false;
+			m_dirtyRegionRenderables.clear();
+			return true;
+		}
+
+		Ogre::Vector2 topLeft( Ogre::Vector2::UNIT_SCALE );
+		Ogre::Vector2 bottomRight( -Ogre::Vector2::UNIT_SCALE );
+
+		for( Renderable *renderable : m_dirtyRegionRenderables )
+			renderable->_addToDirtyRegion( topLeft, bottomRight );
+		m_dirtyRegionRenderables.clear();
+
+		topLeft.makeCeil( -Ogre::Vector2::UNIT_SCALE );
+		bottomRight.makeFloor( Ogre::Vector2::UNIT_SCALE );
+
+		if( topLeft.x >= bottomRight.x || topLeft.y >= bottomRight.y )
+			return false;
+
+		outTopLeft = topLeft;
+		outBottomRight = bottomRight;
+		return true;
+	}
+	//-------------------------------------------------------------------------
+	void ColibriManager::setTaskDispatcher( TaskDispatcher *colibri_nullable dispatcher )
+	{
+		m_taskDispatcher = dispatcher;
+	}
+	//-------------------------------------------------------------------------
+	uint8_t ColibriManager::_getVisualsDirtyFrameCount() const
+	{
+		// In multipass we keep our own copy in m_multipassTmpBuffer (or retained mode is
+		// disabled when using the ring). Otherwise each frame in flight maps a different
+		// region of the buffer.
+		if( m_multipass || !m_vaoManager )
+			return 1u;
+		return m_vaoManager->getDynamicBufferMultiplier();
+	}
+	//-------------------------------------------------------------------------
 	void ColibriManager::setDefaultSkins(
 		std::string defaultSkinPacks[SkinWidgetTypes::NumSkinWidgetTypes] )
 	{
@@ -397,6 +586,8 @@ namespace Colibri
 		for( Window *window : m_windows )
 			window->_notifyCanvasChanged();
 
+		_notifyDirtyRegionFull();
+
 		m_colibriListener->notifyCanvasOrResolutionUpdated();
 	}
 	//-------------------------------------------------------------------------
@@ -777,7 +968,7 @@ namespace Colibri
 			return;
 
 		for( Window *window : m_windows )
-			window->_updateDerivedTransformOnly( -Ogre::Vector2::UNIT_SCALE, Matrix2x3::IDENTITY );
+			window->_updateDerivedTransformIfVisible( -Ogre::Vector2::UNIT_SCALE, Matrix2x3::IDENTITY );
 
 		m_widgetTransformsDirty = false;
 	}
@@ -911,7 +1102,11 @@ namespace Colibri
 		Window *retVal = new Window( this );
 
 		if( !parent )
+		{
 			m_windows.push_back( retVal );
+			_notifyDrawListDirty();
+			_notifyDirtyRegionFull();
+		}
 		else
 		{
 			parent->m_childWindows.push_back( retVal );
@@ -974,6 +1169,9 @@ namespace Colibri
 			return;
 		}
 
+		_notifyDrawListDirty();
+		_notifyDirtyRegionFull();
+
 		if( window == m_cursorFocusedPair.window )
 			m_cursorFocusedPair = FocusPair();
 		if( window == m_keyboardFocusedPair.window )
@@ -1017,6 +1215,9 @@ namespace Colibri
 			return;
 		}
 
+		_notifyDrawListDirty();
+		_notifyDirtyRegionFull();
+
 		if( widget == m_cursorFocusedPair.widget )
 			m_cursorFocusedPair.widget = 0;
 		if( widget == m_keyboardFocusedPair.widget )
@@ -1044,16 +1245,15 @@ namespace Colibri
 
 			if( widget->isLabel() )
 			{
-				// We do not update m_numTextGlyphs since it's pointless to shrink it.
-				// It will eventually be recalculated anyway
+				// Recalculate m_numTextGlyphs so the buffers can be trimmed
+				m_numGlyphsDirty = true;
 				LabelVec::iterator it = std::find( m_labels.begin(), m_labels.end(), widget );
 				Ogre::efficientVectorRemove( m_labels, it );
 				--m_numLabelsAndBmp;
 			}
 			else if( widget->isLabelBmp() )
 			{
-				// We do not update m_numTextGlyphsBmp since it's pointless to shrink it.
-				// It will eventually be recalculated anyway
+				m_numGlyphsBmpDirty = true;
 				LabelBmpVec::iterator it = std::find( m_labelsBmp.begin(), m_labelsBmp.end(), widget );
 				Ogre::efficientVectorRemove( m_labelsBmp, it );
 				--m_numLabelsAndBmp;
@@ -1098,7 +1298,12 @@ namespace Colibri
 		}
 	}
 	//-------------------------------------------------------------------------
-	void ColibriManager::_setAsParentlessWindow( Window *window ) { m_windows.push_back( window ); }
+	void ColibriManager::_setAsParentlessWindow( Window *window )
+	{
+		m_windows.push_back( window );
+		_notifyDrawListDirty();
+		_notifyDirtyRegionFull();
+	}
 	//-------------------------------------------------------------------------
 	void ColibriManager::setAsParentlessWindow( Window *window )
 	{
@@ -1106,6 +1311,8 @@ namespace Colibri
 		{
 			window->detachFromParent();
 			m_windows.push_back( window );
+			_notifyDrawListDirty();
+			_notifyDirtyRegionFull();
 		}
 	}
 	//-------------------------------------------------------------------------
@@ -1166,57 +1373,389 @@ namespace Colibri
 		m_mouseCursorButtonDown = false;
 	}
 	//-----------------------------------------------------------------------------------
+	Ogre::VertexArrayObject *ColibriManager::createVao( uint32_t vertexCount, bool bText )
+	{
+		// The staging + upload path needs BT_DEFAULT buffers. The ring
+		// uses persistent buffers with one region per pass instead.
+		const bool bUploadPath = m_multipass && m_multipassRingSize == 0u;
+		const uint32_t numRegions = std::max( m_multipassRingSize, 1u );
+
+		if( bText )
+		{
+			return Ogre::ColibriOgreRenderable::createTextVao(
+				vertexCount * numRegions, m_vaoManager, bUploadPath, m_glyphIndexBuffer );
+		}
+		return Ogre::ColibriOgreRenderable::createVao( vertexCount * numRegions, m_vaoManager,
+													   bUploadPath, m_nineSliceIndexBuffer );
+	}
+	//-------------------------------------------------------------------------
+	uint32_t ColibriManager::getVerticesPerPass(
+		const Ogre::VertexBufferPacked *vertexBuffer ) const
+	{
+		return static_cast<uint32_t>( vertexBuffer->getNumElements() /
+									  std::max( m_multipassRingSize, 1u ) );
+	}
+	//-------------------------------------------------------------------------
 	void ColibriManager::checkVertexBufferCapacity()
 	{
 		COLIBRI_ASSERT_LOW( m_dirtyLabels.empty() && "updateDirtyLabels has not been called!" );
 		COLIBRI_ASSERT_LOW( m_dirtyLabelBmps.empty() && "updateDirtyLabels has not been called!" );
 
-		bool anyVaoChanged = false;
+		// Vertex buffer for most widgets
+		m_requiredVertices[0] = static_cast<Ogre::uint32>(
+			( m_numWidgets - m_numLabelsAndBmp ) * c_numNineSliceVertices +  // Regular widgets
+			m_numNineSlicesPerCell *                                         // Per cell ones
+				( c_numNineSlicePerCellVertices - c_numNineSliceVertices ) +
+			( m_numTextGlyphsBmp * 6u ) +                                    // BmpLabel
+			m_numCustomShapesVertices                                        // CustomShape
+		);
+		// Vertex buffer for text
+		m_requiredVertices[1] = static_cast<Ogre::uint32>( m_numTextGlyphs * c_numGlyphVertices );
 
+		for( size_t i = 0u; i < 2u; ++i )
 		{
-			// Vertex buffer for most widgets
-			const Ogre::uint32 requiredVertexCount = static_cast<Ogre::uint32>(
-				( m_numWidgets - m_numLabelsAndBmp ) * ( 6u * 9u ) +  // Regular widgets
-				( m_numTextGlyphsBmp * 6u ) +                         // BmpLabel
-				m_numCustomShapesVertices                             // CustomShape
-			);
+			const bool bText = i != 0u;
+			m_vertexHighWaterMark[i] = std::max( m_vertexHighWaterMark[i], m_requiredVertices[i] );
 
-			Ogre::VertexBufferPacked *vertexBuffer = m_vao->getBaseVertexBuffer();
-			const uint32_t currVertexCount = static_cast<uint32_t>( vertexBuffer->getNumElements() );
-			if( requiredVertexCount > currVertexCount )
+			if( !growVaoIfNeeded( m_requiredVertices[i], bText ) && m_autoTrimFrames )
 			{
-				const Ogre::uint32 newVertexCount =
-					std::max( requiredVertexCount, currVertexCount + ( currVertexCount >> 1u ) );
-				Ogre::ColibriOgreRenderable::destroyVao( m_vao, m_vaoManager );
-				m_vao =
-					Ogre::ColibriOgreRenderable::createVao( newVertexCount, m_vaoManager, m_multipass );
+				const uint32_t capacity =
+					getVerticesPerPass( ( bText ? m_textVao : m_vao )->getBaseVertexBuffer() );
+				if( m_requiredVertices[i] < ( capacity >> 1u ) )
+				{
+					++m_lowUsageFrames[i];
+					if( m_lowUsageFrames[i] >= m_autoTrimFrames )
+						trimVao( bText );
+				}
+				else
+				{
+					m_lowUsageFrames[i] = 0u;
+				}
+			}
+		}
+	}
+	//-------------------------------------------------------------------------
+	void ColibriManager::resizeVao( uint32_t newVertexCount, bool bText )
+	{
+		Ogre::VertexArrayObject *&vao = bText ? m_textVao : m_vao;
+
+		Ogre::ColibriOgreRenderable::destroyVao( vao, m_vaoManager );
+		vao = createVao( newVertexCount, bText );
+
+		// Widgets point to m_vertexFormatVao, thus they need not be notified.
+		// But the new buffers are empty, so every frame in flight must be refilled.
+		m_pendingFullRewrites = _getVisualsDirtyFrameCount();
+		m_lowUsageFrames[bText ? 1u : 0u] = 0u;
+	}
+	//-------------------------------------------------------------------------
+	bool ColibriManager::growVaoIfNeeded( uint32_t requiredVertexCount, bool bText )
+	{
+		Ogre::VertexArrayObject *vao = bText ? m_textVao : m_vao;
+
+		const uint32_t currVertexCount = getVerticesPerPass( vao->getBaseVertexBuffer() );
+		if( requiredVertexCount <= currVertexCount )
+			return false;
+
+		// Grow geometrically and in whole chunks, so that creating
+		// widgets one by one doesn't reallocate every few frames.
+		uint32_t newVertexCount =
+			std::max( requiredVertexCount, currVertexCount + ( currVertexCount >> 1u ) );
+		newVertexCount = ( ( newVertexCount + c_vertexBufferChunkSize - 1u ) /
+						   c_vertexBufferChunkSize ) * c_vertexBufferChunkSize;
+		resizeVao( newVertexCount, bText );
+
+		return true;
+	}
+	//-------------------------------------------------------------------------
+	void ColibriManager::trimVao( bool bText )
+	{
+		const size_t idx = bText ? 1u : 0u;
+		Ogre::VertexArrayObject *vao = bText ? m_textVao : m_vao;
+
+		uint32_t newVertexCount =
+			std::max( std::max( m_requiredVertices[idx], m_reservedVertices[idx] ), 1u );
+		newVertexCount = ( ( newVertexCount + c_vertexBufferChunkSize - 1u ) /
+						   c_vertexBufferChunkSize ) * c_vertexBufferChunkSize;
+
+		if( newVertexCount < getVerticesPerPass( vao->getBaseVertexBuffer() ) )
+			resizeVao( newVertexCount, bText );
+		m_lowUsageFrames[idx] = 0u;
+	}
+	//-------------------------------------------------------------------------
+	void ColibriManager::reserve( uint32_t numWidgets, uint32_t numGlyphs )
+	{
+		COLIBRI_ASSERT_LOW( m_vao && "Call setOgre first!" );
+		m_reservedVertices[0] = numWidgets * c_numNineSliceVertices;
+		m_reservedVertices[1] = numGlyphs * c_numGlyphVertices;
+		growVaoIfNeeded( m_reservedVertices[0], false );
+		growVaoIfNeeded( m_reservedVertices[1], true );
+	}
+	//-------------------------------------------------------------------------
+	void ColibriManager::trimBuffers()
+	{
+		COLIBRI_ASSERT_LOW( m_vao && "Call setOgre first!" );
+		COLIBRI_ASSERT_MEDIUM( !m_fillBuffersStarted );
+		COLIBRI_ASSERT_MEDIUM( !m_renderingStarted );
+
+		// Bring m_requiredVertices up to date
+		_updateDirtyLabels();
+		checkVertexBufferCapacity();
+
+		trimVao( false );
+		trimVao( true );
+	}
+	//-------------------------------------------------------------------------
+	void ColibriManager::setAutoTrimBuffers( uint32_t numFrames )
+	{
+		m_autoTrimFrames = numFrames;
+		m_lowUsageFrames[0] = 0u;
+		m_lowUsageFrames[1] = 0u;
+	}
+	//-------------------------------------------------------------------------
+	VertexBufferStats ColibriManager::getVertexBufferStats( bool bText ) const
+	{
+		const size_t idx = bText ? 1u : 0u;
+		Ogre::VertexArrayObject *vao = bText ? m_textVao : m_vao;
+
+		VertexBufferStats retVal;
+		retVal.usedVertices = m_requiredVertices[idx];
+		retVal.capacity = vao ? getVerticesPerPass( vao->getBaseVertexBuffer() ) : 0u;
+		retVal.highWaterMark = m_vertexHighWaterMark[idx];
+		return retVal;
+	}
+	//-------------------------------------------------------------------------
+	void ColibriManager::resetVertexBufferHighWaterMarks()
+	{
+		m_vertexHighWaterMark[0] = m_requiredVertices[0];
+		m_vertexHighWaterMark[1] = m_requiredVertices[1];
+	}
+	//-------------------------------------------------------------------------
+	void ColibriManager::collectReorderedDraws( const Widget *widget )
+	{
+		// Children Windows are at the end and aren't included
+		for( size_t i = 0u; i < widget->m_numWidgets; ++i )
+		{
+			Widget *child = widget->m_children[i];
+			if( child->m_culled )
+				continue;
 
-				anyVaoChanged = true;
+			if( child->isRenderable() )
+			{
+				Renderable *renderable = static_cast<Renderable *>( child );
+				if( renderable->isVisualsEnabled() )
+				{
+					const Matrix2x3 &rot = child->m_derivedOrientation;
+
+					ReorderedDraw draw;
+					draw.renderable = renderable;
+					draw.datablock = renderable->getDatablock();
+					draw.renderType = static_cast<uint8_t>(
+						child->isLabelBmp() ? WidgetRenderType::CustomShape + 1
+											: child->getWidgetRenderType() );
+					// Same criteria as Widget::_isSubtreeOverlapFree
+					draw.bUnbounded = rot.m[0][0] != 1.0f || rot.m[0][1] != 0.0f ||
+									  rot.m[1][0] != 0.0f || rot.m[1][1] != 1.0f ||
+									  child->getWidgetRenderType() != WidgetRenderType::Normal ||
+									  child->isLabelBmp();
+					draw.topLeft = child->m_derivedTopLeft;
+					draw.bottomRight = child->m_derivedBottomRight;
+					draw.nextInBatch = std::numeric_limits<size_t>::max();
+					m_reorderedDraws.push_back( draw );
+				}
 			}
+
+			collectReorderedDraws( child );
+		}
+	}
+	//-------------------------------------------------------------------------
+	static bool rectsOverlap( const Ogre::Vector2 &aTL, const Ogre::Vector2 &aBR,
+							  const Ogre::Vector2 &bTL, const Ogre::Vector2 &bBR )
+	{
+		return aTL.x < bBR.x && bTL.x < aBR.x && aTL.y < bBR.y && bTL.y < aBR.y;
+	}
+	//-------------------------------------------------------------------------
+	bool ColibriManager::overlapsBatch( const ReorderedDraw &draw, const ReorderBatch &batch ) const
+	{
+		if( draw.bUnbounded || batch.bUnbounded )
+			return true;
+
+		// Quick rejection against the union of all rects
+		if( !rectsOverlap( draw.topLeft, draw.bottomRight, batch.topLeft, batch.bottomRight ) )
+			return false;
+
+		size_t drawIdx = batch.firstDraw;
+		while( drawIdx != std::numeric_limits<size_t>::max() )
+		{
+			const ReorderedDraw &other = m_reorderedDraws[drawIdx];
+			if( rectsOverlap( draw.topLeft, draw.bottomRight, other.topLeft, other.bottomRight ) )
+				return true;
+			drawIdx = other.nextInBatch;
 		}
 
+		return false;
+	}
+	//-------------------------------------------------------------------------
+	void ColibriManager::_addReorderedChildrenCommands( Widget *widget,
+														ApiEncapsulatedObjects &apiObject )
+	{
+		m_reorderedDraws.clear();
+		m_reorderBatches.clear();
+
+		collectReorderedDraws( widget );
+
+		// Greedily move each draw back into the most recent batch sharing its datablock &
+		// vertex buffer, but never past a batch that it overlaps (that would break painter's
+		// order). If there's no such batch, the draw starts a new one.
+		const size_t numDraws = m_reorderedDraws.size();
+		for( size_t i = 0u; i < numDraws; ++i )
 		{
-			// Vertex buffer for text
-			const Ogre::uint32 requiredVertexCount = static_cast<Ogre::uint32>( m_numTextGlyphs * 6u );
+			ReorderedDraw &draw = m_reorderedDraws[i];
+
+			const size_t numBatches = m_reorderBatches.size();
+			const size_t lookback = std::min( numBatches, c_maxReorderLookback );
+			size_t batchIdx = numBatches;
+			for( size_t j = 0u; j < lookback; ++j )
+			{
+				const ReorderBatch &batch = m_reorderBatches[numBatches - j - 1u];
+				if( m_reorderedDraws[batch.firstDraw].sameBatchAs( draw ) )
+				{
+					batchIdx = numBatches - j - 1u;
+					break;
+				}
+				if( overlapsBatch( draw, batch ) )
+					break;
+			}
 
-			Ogre::VertexBufferPacked *vertexBuffer = m_textVao->getBaseVertexBuffer();
-			const Ogre::uint32 currVertexCount = (uint32_t)vertexBuffer->getNumElements();
-			if( requiredVertexCount > currVertexCount )
+			if( batchIdx == numBatches )
+			{
+				ReorderBatch batch;
+				batch.firstDraw = i;
+				batch.lastDraw = i;
+				batch.bUnbounded = draw.bUnbounded;
+				batch.topLeft = draw.topLeft;
+				batch.bottomRight = draw.bottomRight;
+				m_reorderBatches.push_back( batch );
+			}
+			else
 			{
-				const Ogre::uint32 newVertexCount =
-					std::max( requiredVertexCount, currVertexCount + ( currVertexCount >> 1u ) );
-				Ogre::ColibriOgreRenderable::destroyVao( m_textVao, m_vaoManager );
-				m_textVao = Ogre::ColibriOgreRenderable::createTextVao( newVertexCount, m_vaoManager,
-																		m_multipass );
-				anyVaoChanged = true;
+				ReorderBatch &batch = m_reorderBatches[batchIdx];
+				m_reorderedDraws[batch.lastDraw].nextInBatch = i;
+				batch.lastDraw = i;
+				batch.bUnbounded |= draw.bUnbounded;
+				batch.topLeft.makeFloor( draw.topLeft );
+				batch.bottomRight.makeCeil( draw.bottomRight );
 			}
 		}
 
-		if( anyVaoChanged )
+		// Gather stats
+		for( size_t i = 0u; i < numDraws; ++i )
 		{
-			for( Window *window : m_windows )
-				window->broadcastNewVao( m_vao, m_textVao );
+			if( i == 0u || !m_reorderedDraws[i - 1u].sameBatchAs( m_reorderedDraws[i] ) )
+				++m_numDrawsBeforeReorder;
+		}
+		for( size_t i = 0u; i < m_reorderBatches.size(); ++i )
+		{
+			if( i == 0u || !m_reorderedDraws[m_reorderBatches[i - 1u].firstDraw].sameBatchAs(
+							   m_reorderedDraws[m_reorderBatches[i].firstDraw] ) )
+			{
+				++m_numDrawsAfterReorder;
+			}
+		}
+
+		for( const ReorderBatch &batch : m_reorderBatches )
+		{
+			size_t drawIdx = batch.firstDraw;
+			while( drawIdx != std::numeric_limits<size_t>::max() )
+			{
+				const ReorderedDraw &draw = m_reorderedDraws[drawIdx];
+				if( apiObject.drawList )
+					apiObject.drawList->push_back( draw.renderable );
+				draw.renderable->_addDrawCommands( apiObject );
+				drawIdx = draw.nextInBatch;
+			}
+		}
+
+		// The order depends on where the widgets are, which can change without invalidating
+		// the cached draw list. Keep it dirty so the next frame reorders again.
+		_notifyDrawListDirty();
+
+		// Children Windows are drawn on top, as usual
+		for( size_t i = widget->m_numWidgets; i < widget->m_children.size(); ++i )
+		{
+			COLIBRI_ASSERT_HIGH( dynamic_cast<Renderable *>( widget->m_children[i] ) );
+			static_cast<Renderable *>( widget->m_children[i] )->_addCommands( apiObject, false );
+		}
+	}
+	//-----------------------------------------------------------------------------------
+	bool ColibriManager::calculateWindowVertexSlices()
+	{
+		m_windowVertexSlices.resize( m_windows.size() );
+
+		size_t numVertices = 0u;
+		size_t numTextVertices = 0u;
+
+		WindowVertexSliceVec::iterator itSlice = m_windowVertexSlices.begin();
+
+		for( const Window *window : m_windows )
+		{
+			itSlice->vertexStart = numVertices;
+			itSlice->textVertexStart = numTextVertices;
+			itSlice->vertexEnd = numVertices;
+			itSlice->textVertexEnd = numTextVertices;
+			window->_getVertexCountUpperBound( numVertices, numTextVertices );
+			++itSlice;
 		}
+
+		return numVertices <= getVerticesPerPass( m_vao->getBaseVertexBuffer() ) &&
+			   numTextVertices <= getVerticesPerPass( m_textVao->getBaseVertexBuffer() );
+	}
+	//-----------------------------------------------------------------------------------
+	void ColibriManager::fillWindowBuffers( size_t windowIdx )
+	{
+		WindowVertexSlice &slice = m_windowVertexSlices[windowIdx];
+
+		UiVertex *vertex = m_vertexBufferBase + slice.vertexStart;
+		GlyphVertex *vertexText = m_textVertexBufferBase + slice.textVertexStart;
+
+		m_windows[windowIdx]->_fillBuffersAndCommands( &vertex, &vertexText,
+													   -Ogre::Vector2::UNIT_SCALE,
+													   Ogre::Vector2::ZERO, Matrix2x3::IDENTITY );
+
+		slice.vertexEnd = size_t( vertex - m_vertexBufferBase );
+		slice.textVertexEnd = size_t( vertexText - m_textVertexBufferBase );
+	}
+	//-----------------------------------------------------------------------------------
+	bool ColibriManager::haveWindowVertexSlicesOverflowed() const
+	{
+		const size_t numSlices = m_windowVertexSlices.size();
+		for( size_t i = 0u; i + 1u < numSlices; ++i )
+		{
+			const WindowVertexSlice &slice = m_windowVertexSlices[i];
+			const WindowVertexSlice &nextSlice = m_windowVertexSlices[i + 1u];
+			if( slice.vertexEnd > nextSlice.vertexStart ||
+				slice.textVertexEnd > nextSlice.textVertexStart )
+			{
+				return true;
+			}
+		}
+
+		// The last slice ends where the mapped region does
+		if( numSlices > 0u )
+		{
+			const WindowVertexSlice &lastSlice = m_windowVertexSlices.back();
+			if( lastSlice.vertexEnd > getVerticesPerPass( m_vao->getBaseVertexBuffer() ) ||
+				lastSlice.textVertexEnd > getVerticesPerPass( m_textVao->getBaseVertexBuffer() ) )
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+	//-----------------------------------------------------------------------------------
+	void ColibriManager::fillWindowBuffersTask( void *colibri_nullable userData, size_t windowIdx )
+	{
+		static_cast<ColibriManager *>( userData )->fillWindowBuffers( windowIdx );
 	}
 	//-----------------------------------------------------------------------------------
 	UiVertex *ColibriManager::getMultipassVertexBuffer( size_t numElements, size_t textNumElements )
@@ -1389,6 +1928,12 @@ namespace Colibri
 	//-------------------------------------------------------------------------
 	void ColibriManager::_notifyNumGlyphsBmpIsDirty() { m_numGlyphsBmpDirty = true; }
 	//-------------------------------------------------------------------------
+	void ColibriManager::_notifyGlyphsRasterized()
+	{
+		for( Label *label : m_labels )
+			label->_notifyGlyphsRasterized();
+	}
+	//-------------------------------------------------------------------------
 	void ColibriManager::_updateDirtyLabels()
 	{
 		COLIBRI_ASSERT_MEDIUM( !m_fillBuffersStarted );
@@ -1469,6 +2014,8 @@ namespace Colibri
 	{
 		if( m_zOrderWidgetDirty )
 		{
+			_notifyDrawListDirty();
+			_notifyDirtyRegionFull();
 			reorderWindowVec( m_zOrderHasDirtyChildren, m_windows );
 
 			m_zOrderWidgetDirty = false;
@@ -1554,6 +2101,13 @@ namespace Colibri
 		m_numCustomShapesVertices = static_cast<size_t>( newVertexCount );
 	}
 	//-------------------------------------------------------------------------
+	void ColibriManager::_addNineSlicesPerCellChange( int32_t countDiff )
+	{
+		int32_t newCount = static_cast<int32_t>( m_numNineSlicesPerCell ) + countDiff;
+		COLIBRI_ASSERT_LOW( newCount >= 0 );
+		m_numNineSlicesPerCell = static_cast<size_t>( newCount );
+	}
+	//-------------------------------------------------------------------------
 	void ColibriManager::_stealKeyboardFocus( Widget *widget )
 	{
 		COLIBRI_ASSERT_LOW( widget );
@@ -1677,6 +2231,16 @@ namespace Colibri
 			updateWidgetsFocusedByCursor();
 		}
 
+		// The ShaperManager is shared with secondary managers (see _setPrimary). Whoever
+		// processes the results first, every manager must notify its own Labels.
+		m_shaperManager->processRasterizedGlyphs();
+		const uint32_t rasterizedGlyphsGeneration = m_shaperManager->getRasterizedGlyphsGeneration();
+		if( m_rasterizedGlyphsGeneration != rasterizedGlyphsGeneration )
+		{
+			m_rasterizedGlyphsGeneration = rasterizedGlyphsGeneration;
+			_notifyGlyphsRasterized();
+		}
+
 		m_shaperManager->updateGpuBuffers();
 
 		for( Widget *updateWidget : m_updateWidgets )
@@ -1692,11 +2256,39 @@ namespace Colibri
 		Ogre::VertexBufferPacked *vertexBuffer = m_vao->getBaseVertexBuffer();
 		Ogre::VertexBufferPacked *vertexBufferText = m_textVao->getBaseVertexBuffer();
 
+		const uint32_t currFrameIdx = m_vaoManager->getFrameCount();
+
+		// With the ring, multipass maps the buffers directly like the regular path does
+		const bool bUploadPath = m_multipass && m_multipassRingSize == 0u;
+		const size_t vertexCapacity = getVerticesPerPass( vertexBuffer );
+		const size_t textVertexCapacity = getVerticesPerPass( vertexBufferText );
+
+		bool bAdvanceFrame = true;
+		if( m_multipassRingSize )
+		{
+			// Only the first pass of the frame advances to the next frame in flight.
+			// The rest of the passes write to their own region of the same frame.
+			bAdvanceFrame = currFrameIdx != m_lastFrameIdxFilled;
+			if( bAdvanceFrame )
+				m_multipassPassIdx = 0u;
+			else if( m_multipassPassIdx + 1u < m_multipassRingSize )
+				++m_multipassPassIdx;
+			else
+			{
+				COLIBRI_ASSERT_LOW( false && "Called prepareRenderCommands more times in the same "
+											"frame than the value passed to setMultipassRingSize" );
+				m_logListener->log( "ColibriManager::prepareRenderCommands: ran out of multipass "
+									"ring regions. Increase setMultipassRingSize. Overwriting last "
+									"region",
+									LogSeverity::Error );
+			}
+		}
+
 		UiVertex *vertex = 0;
-		if( !m_multipass )
+		if( !bUploadPath )
 		{
-			vertex =
-				reinterpret_cast<UiVertex *>( vertexBuffer->map( 0, vertexBuffer->getNumElements() ) );
+			vertex = reinterpret_cast<UiVertex *>( vertexBuffer->map(
+				m_multipassPassIdx * vertexCapacity, vertexCapacity, bAdvanceFrame ) );
 		}
 		else
 		{
@@ -1708,10 +2300,10 @@ namespace Colibri
 		m_vertexBufferBase = vertex;
 
 		GlyphVertex *vertexText = 0;
-		if( !m_multipass )
+		if( !bUploadPath )
 		{
-			vertexText = reinterpret_cast<GlyphVertex *>(
-				vertexBufferText->map( 0, vertexBufferText->getNumElements() ) );
+			vertexText = reinterpret_cast<GlyphVertex *>( vertexBufferText->map(
+				m_multipassPassIdx * textVertexCapacity, textVertexCapacity, bAdvanceFrame ) );
 		}
 		else
 		{
@@ -1722,18 +2314,67 @@ namespace Colibri
 		const GlyphVertex *startOffsetText = vertexText;
 		m_textVertexBufferBase = vertexText;
 
-		for( Window *window : m_windows )
+		// Retained mode relies on each frame in flight being filled exactly once. If we skipped
+		// a frame (or got called twice in the same frame) the regions are no longer in sync.
+		// The multipass ring writes each pass to a different region, so it can't be retained.
+		m_rewriteAllVertices = !m_retainedVertexBuffers || m_multipassRingSize != 0u ||
+							   m_pendingFullRewrites != 0u ||
+							   ( !m_multipass && currFrameIdx != m_lastFrameIdxFilled + 1u );
+		if( m_pendingFullRewrites )
+			--m_pendingFullRewrites;
+		m_lastFrameIdxFilled = currFrameIdx;
+		++m_fillPassIdx;
+		m_numVerticesRewritten = 0u;
+		m_numTextVerticesRewritten = 0u;
+
+		bool bFillSerially = true;
+
+		if( m_taskDispatcher && calculateWindowVertexSlices() )
+		{
+			m_taskDispatcher->dispatch( m_windows.size(), fillWindowBuffersTask, this );
+
+			if( colibri_likely( !haveWindowVertexSlicesOverflowed() ) )
+			{
+				bFillSerially = false;
+				if( !m_windowVertexSlices.empty() )
+				{
+					// Slices are sorted, thus the last one tells us how much was written.
+					vertex += m_windowVertexSlices.back().vertexEnd;
+					vertexText += m_windowVertexSlices.back().textVertexEnd;
+				}
+			}
+			else
+			{
+				// A widget wrote more than its upper bound. That breaks the contract of
+				// Widget::_getVertexCountUpperBound (Labels clamp their writes to it), so
+				// this is a bug in a widget and the damage is done. Fill everything again
+				// serially to at least render a correct frame, and rewrite all vertices
+				// since retained ones may have been overwritten.
+				COLIBRI_ASSERT_LOW( false && "Window wrote more vertices than its upper bound!" );
+				m_logListener->log( "Window wrote more vertices than its upper bound. "
+									"Filling the vertex buffers serially.",
+									LogSeverity::Error );
+				m_rewriteAllVertices = true;
+				m_pendingFullRewrites = _getVisualsDirtyFrameCount();
+				++m_fillPassIdx;
+			}
+		}
+
+		if( bFillSerially )
 		{
-			window->_fillBuffersAndCommands( &vertex, &vertexText, -Ogre::Vector2::UNIT_SCALE,
-											 Ogre::Vector2::ZERO, Matrix2x3::IDENTITY );
+			for( Window *window : m_windows )
+			{
+				window->_fillBuffersAndCommands( &vertex, &vertexText, -Ogre::Vector2::UNIT_SCALE,
+												 Ogre::Vector2::ZERO, Matrix2x3::IDENTITY );
+			}
 		}
 
 		const size_t elementsWritten = size_t( vertex - startOffset );
 		const size_t elementsWrittenText = size_t( vertexText - startOffsetText );
-		COLIBRI_ASSERT( elementsWritten <= vertexBuffer->getNumElements() );
-		COLIBRI_ASSERT( elementsWrittenText <= vertexBufferText->getNumElements() );
+		COLIBRI_ASSERT( elementsWritten <= vertexCapacity );
+		COLIBRI_ASSERT( elementsWrittenText <= textVertexCapacity );
 
-		if( !m_multipass )
+		if( !bUploadPath )
 		{
 			vertexBuffer->unmap( Ogre::UO_KEEP_PERSISTENT, 0u, elementsWritten );
 			vertexBufferText->unmap( Ogre::UO_KEEP_PERSISTENT, 0u, elementsWrittenText );
@@ -1804,29 +2445,56 @@ namespace Colibri
 			apiObjects.baseInstanceAndIndirectBuffers = 1;
 		apiObjects.drawCmd = 0;
 		apiObjects.drawCountPtr = 0;
+		apiObjects.drawCmdIndexed = false;
 		apiObjects.primCount = 0;
+		apiObjects.vao[0] = m_vao;
+		apiObjects.vao[1] = m_textVao;
 		apiObjects.basePrimCount[0] = (uint32_t)m_vao->getBaseVertexBuffer()->_getFinalBufferStart();
 		apiObjects.basePrimCount[1] = (uint32_t)m_textVao->getBaseVertexBuffer()->_getFinalBufferStart();
+		if( m_multipassRingSize )
+		{
+			// Draw from the region written by the last prepareRenderCommands
+			apiObjects.basePrimCount[0] +=
+				m_multipassPassIdx * getVerticesPerPass( m_vao->getBaseVertexBuffer() );
+			apiObjects.basePrimCount[1] +=
+				m_multipassPassIdx * getVerticesPerPass( m_textVao->getBaseVertexBuffer() );
+		}
 		apiObjects.nextFirstVertex = 0;
+		apiObjects.textChainLength = 0u;
+		apiObjects.textDrawSlot = 0u;
+		apiObjects.nextTextDrawSlot = 0u;
+		apiObjects.drawList = 0;
 
-		m_breadthFirst[0].clear();
-		m_breadthFirst[1].clear();
-		m_breadthFirst[2].clear();
-		m_breadthFirst[3].clear();
+		m_numDrawsBeforeReorder = 0u;
+		m_numDrawsAfterReorder = 0u;
+		m_numAutoBreadthFirst = 0u;
 
-		for( Window *window : m_windows )
-			window->_addCommands( apiObjects, false );
+		if( !m_drawListCaching || m_drawListDirty.load( std::memory_order_relaxed ) )
+		{
+			if( m_drawListCaching )
+			{
+				m_drawList.clear();
+				apiObjects.drawList = &m_drawList;
+			}
+			m_drawListDirty.store( false, std::memory_order_relaxed );
 
-		if( apiObjects.drawCountPtr && apiObjects.drawCountPtr->primCount == 0u )
+			m_breadthFirst[0].clear();
+			m_breadthFirst[1].clear();
+			m_breadthFirst[2].clear();
+			m_breadthFirst[3].clear();
+
+			for( Window *window : m_windows )
+				window->_addCommands( apiObjects, false );
+		}
+		else
 		{
-			// Adreno 618 will GPU crash if we send an indirect cmd with vertex_count = 0
-			--apiObjects.drawCmd->numDraws;
-			// Since we only emit CbDrawStrip we can assume the previous cmd
-			// issued a CbDrawStrip, so take it back. Otherwise we'd have to
-			// save what our last cmd was.
-			apiObjects.indirectDraw -= sizeof( Ogre::CbDrawStrip );
+			// Same Renderables in the same order as last time. No need to traverse
+			for( Renderable *renderable : m_drawList )
+				renderable->_addDrawCommands( apiObjects );
 		}
 
+		Renderable::_discardEmptyDraw( apiObjects );
+
 		if( m_vaoManager->supportsIndirectBuffers() )
 			apiObjects.indirectBuffer->unmap( Ogre::UO_KEEP_PERSISTENT );
 
@@ -1845,4 +2513,12 @@ namespace Colibri
 	LogListener::~LogListener() {}
 	//-------------------------------------------------------------------------
 	ColibriListener::~ColibriListener() {}
+	//-------------------------------------------------------------------------
+	TaskDispatcher::~TaskDispatcher() {}
+	//-------------------------------------------------------------------------
+	void TaskDispatcher::dispatch( size_t numTasks, TaskFunc task, void *colibri_nullable userData )
+	{
+		for( size_t i = 0u; i < numTasks; ++i )
+			task( userData, i );
+	}
 }
@@ -7,8 +7,10 @@
 #include "Compositor/OgreCompositorManager2.h"
 #include "Compositor/OgreCompositorNodeDef.h"
 #include "Compositor/OgreCompositorWorkspace.h"
+#include "Compositor/Pass/PassQuad/OgreCompositorPassQuadDef.h"
 #include "OgreDepthBuffer.h"
 #include "OgreHlmsManager.h"
+#include "OgreHlmsUnlitDatablock.h"
 #include "OgreId.h"
 #include "OgreLwString.h"
 #include "OgreRenderSystem.h"
@@ -18,12 +20,15 @@
 using namespace Colibri;
 
 static const char *kOffscreenDefaultWorkspaceName = "!#ColibriOffScreenCanvasWorkspace";
+static const char *kOffscreenPartialWorkspaceName = "!#ColibriOffScreenCanvasPartialWorkspace";
 
 OffScreenCanvas::OffScreenCanvas( ColibriManager *primaryManager ) :
 	m_secondaryManager( new ColibriManager( primaryManager->getLogListener(),
 											primaryManager->getColibriListener(), true, true ) ),
 	m_workspace( 0 ),
-	m_canvasTexture( 0 )
+	m_canvasTexture( 0 ),
+	m_partialUpdates( false ),
+	m_partialTargetDef( 0 )
 {
 	m_secondaryManager->_setPrimary( primaryManager );
 }
@@ -72,6 +77,76 @@ void OffScreenCanvas::createWorkspaceDefinition()
 	workDef->connectExternal( 0, kOffscreenDefaultNodeName, 0 );
 }
 //-----------------------------------------------------------------------------
+void OffScreenCanvas::createPartialWorkspaceDefinition()
+{
+	using namespace Ogre;
+	CompositorManager2 *compositorManager = m_secondaryManager->getOgreRoot()->getCompositorManager2();
+
+	const static String kOffscreenPartialNodeName = "!#ColibriOffScreenCanvasPartialNode";
+	const static String kOffscreenClearDatablockName = "!#ColibriOffScreenCanvasClear";
+
+	if( compositorManager->hasNodeDefinition( kOffscreenPartialNodeName ) )
+	{
+		CompositorNodeDef *nodeDef =
+			compositorManager->getNodeDefinitionNonConst( kOffscreenPartialNodeName );
+		m_partialTargetDef = nodeDef->getTargetPass( 0u );
+		return;
+	}
+
+	// Load actions can only clear the whole texture. We clear the dirty region by drawing a quad
+	// without blending, restricted by the same scissor as the Colibri pass.
+	HlmsManager *hlmsManager = m_secondaryManager->getOgreHlmsManager();
+	if( !hlmsManager->getDatablockNoDefault( kOffscreenClearDatablockName ) )
+	{
+		HlmsMacroblock macroblock;
+		macroblock.mDepthCheck = false;
+		macroblock.mDepthWrite = false;
+		macroblock.mScissorTestEnabled = true;
+
+		Hlms *hlms = hlmsManager->getHlms( HLMS_UNLIT );
+		HlmsUnlitDatablock *datablock = static_cast<HlmsUnlitDatablock *>(
+			hlms->createDatablock( kOffscreenClearDatablockName, kOffscreenClearDatablockName,
+								   macroblock, HlmsBlendblock(), HlmsParamVec() ) );
+		datablock->setUseColour( true );
+		datablock->setColour( ColourValue( 0, 0, 0, 0 ) );
+	}
+
+	CompositorNodeDef *nodeDef = compositorManager->addNodeDefinition( kOffscreenPartialNodeName );
+	nodeDef->addTextureSourceName( "rt_output", 0, TextureDefinitionBase::TEXTURE_INPUT );
+
+	nodeDef->setNumTargetPass( 1u );
+	CompositorTargetDef *targetDef = nodeDef->addTargetPass( "rt_output" );
+	targetDef->setNumPasses( 2u );
+
+	CompositorPassQuadDef *passQuad =
+		static_cast<CompositorPassQuadDef *>( targetDef->addPass( PASS_QUAD ) );
+#if OGRE_VERSION >= OGRE_MAKE_VERSION( 2, 3, 0 )
+	passQuad->mSkipLoadStoreSemantics = false;
+#endif
+	passQuad->mMaterialName = kOffscreenClearDatablockName;
+	passQuad->mMaterialIsHlms = true;
+	passQuad->setAllLoadActions( LoadAction::Load );
+	passQuad->mStoreActionDepth = StoreAction::DontCare;
+	passQuad->mStoreActionStencil = StoreAction::DontCare;
+	passQuad->mProfilingId = "OffScreenCanvas Partial Clear";
+
+	CompositorPassColibriGuiDef *passColibri =
+		static_cast<CompositorPassColibriGuiDef *>( targetDef->addPass( PASS_CUSTOM, "colibri_gui" ) );
+#if OGRE_VERSION >= OGRE_MAKE_VERSION( 2, 3, 0 )
+	passColibri->mSkipLoadStoreSemantics = false;
+#endif
+	passColibri->setAllLoadActions( LoadAction::Load );
+	passColibri->mStoreActionDepth = StoreAction::DontCare;
+	passColibri->mStoreActionStencil = StoreAction::DontCare;
+	passColibri->mProfilingId = "OffScreenCanvas Colibri";
+
+	CompositorWorkspaceDef *workDef =
+		compositorManager->addWorkspaceDefinition( kOffscreenPartialWorkspaceName );
+	workDef->connectExternal( 0, kOffscreenPartialNodeName, 0 );
+
+	m_partialTargetDef = targetDef;
+}
+//-----------------------------------------------------------------------------
 void OffScreenCanvas::createWorkspace( Ogre::CompositorPassColibriGuiProvider *colibriCompositorProvider,
 									   Ogre::Camera *camera )
 {
@@ -79,16 +154,26 @@ void OffScreenCanvas::createWorkspace( Ogre::CompositorPassColibriGuiProvider *c
 		m_secondaryManager->getOgreRoot()->getCompositorManager2();
 
 	destroyWorkspace();
-	createWorkspaceDefinition();
+
+	const char *workspaceName = kOffscreenDefaultWorkspaceName;
+	if( m_partialUpdates )
+	{
+		createPartialWorkspaceDefinition();
+		workspaceName = kOffscreenPartialWorkspaceName;
+	}
+	else
+		createWorkspaceDefinition();
 
 	ColibriManager *oldValue = colibriCompositorProvider->getColibriManager();
 	colibriCompositorProvider->_setColibriManager( m_secondaryManager );
 
-	m_workspace =
-		compositorManager->addWorkspace( m_secondaryManager->getOgreSceneManager(), m_canvasTexture,
-										 camera, kOffscreenDefaultWorkspaceName, false );
+	m_workspace = compositorManager->addWorkspace( m_secondaryManager->getOgreSceneManager(),
+												   m_canvasTexture, camera, workspaceName, false );
 
 	colibriCompositorProvider->_setColibriManager( oldValue );
+
+	// The texture's contents are unknown
+	m_secondaryManager->invalidateDirtyRegion();
 }
 //-----------------------------------------------------------------------------
 void OffScreenCanvas::setWorkspace( Ogre::CompositorWorkspace *colibri_nullable workspace,
@@ -99,6 +184,8 @@ void OffScreenCanvas::setWorkspace( Ogre::CompositorWorkspace *colibri_nullable
 	if( bDestroyCurrent )
 		destroyWorkspace();
 	m_workspace = workspace;
+	m_partialTargetDef = 0;
+	m_secondaryManager->invalidateDirtyRegion();
 }
 //-----------------------------------------------------------------------------
 void OffScreenCanvas::destroyWorkspace()
@@ -108,6 +195,7 @@ void OffScreenCanvas::destroyWorkspace()
 		m_workspace->getCompositorManager()->removeWorkspace( m_workspace );
 		m_workspace = 0;
 	}
+	m_partialTargetDef = 0;
 }
 //-----------------------------------------------------------------------------
 void OffScreenCanvas::createTexture( uint32_t width, uint32_t height, Ogre::PixelFormatGpu pixelFormat )
@@ -184,10 +272,50 @@ Ogre::TextureGpu *OffScreenCanvas::disownCanvasTexture( const bool bCreateAnothe
 	return retVal;
 }
 //-----------------------------------------------------------------------------
-void OffScreenCanvas::updateCanvas( const float timeSinceLast )
+void OffScreenCanvas::setPartialUpdates( bool bPartialUpdates )
+{
+	m_partialUpdates = bPartialUpdates;
+	m_secondaryManager->setDirtyRegionTracking( bPartialUpdates );
+}
+//-----------------------------------------------------------------------------
+void OffScreenCanvas::setScissorRegion( const Ogre::Vector2 &topLeft, const Ogre::Vector2 &bottomRight )
+{
+	const Ogre::Vector2 resolution( static_cast<Ogre::Real>( m_canvasTexture->getWidth() ),
+									static_cast<Ogre::Real>( m_canvasTexture->getHeight() ) );
+
+	// Round outwards to whole pixels, with an extra pixel for the pixels that were
+	// snapped, filtered or antialiased into our region.
+	Ogre::Vector2 pixelTL = ( topLeft + 1.0f ) * 0.5f * resolution;
+	Ogre::Vector2 pixelBR = ( bottomRight + 1.0f ) * 0.5f * resolution;
+	pixelTL.x = std::max( floorf( pixelTL.x ) - 1.0f, 0.0f );
+	pixelTL.y = std::max( floorf( pixelTL.y ) - 1.0f, 0.0f );
+	pixelBR.x = std::min( ceilf( pixelBR.x ) + 1.0f, resolution.x );
+	pixelBR.y = std::min( ceilf( pixelBR.y ) + 1.0f, resolution.y );
+
+	const Ogre::Vector2 scissorTL = pixelTL / resolution;
+	const Ogre::Vector2 scissorSize = ( pixelBR - pixelTL ) / resolution;
+
+	for( Ogre::CompositorPassDef *passDef : m_partialTargetDef->getCompositorPasses() )
+	{
+		passDef->mVpRect[0].mVpScissorLeft = scissorTL.x;
+		passDef->mVpRect[0].mVpScissorTop = scissorTL.y;
+		passDef->mVpRect[0].mVpScissorWidth = scissorSize.x;
+		passDef->mVpRect[0].mVpScissorHeight = scissorSize.y;
+	}
+}
+//-----------------------------------------------------------------------------
+bool OffScreenCanvas::updateCanvas( const float timeSinceLast )
 {
 	m_secondaryManager->update( timeSinceLast );
 
+	Ogre::Vector2 dirtyTopLeft, dirtyBottomRight;
+	if( !m_secondaryManager->flushDirtyRegion( dirtyTopLeft, dirtyBottomRight ) )
+		return false;
+
+	// The workspace definition is shared by all canvases, so this must be set every time
+	if( m_partialTargetDef )
+		setScissorRegion( dirtyTopLeft, dirtyBottomRight );
+
 	// m_workspace->_beginUpdate( true );
 	m_workspace->_update();
 	// m_workspace->_endUpdate( true );
@@ -207,4 +335,6 @@ void OffScreenCanvas::updateCanvas( const float timeSinceLast )
 							  1u << GPT_FRAGMENT_PROGRAM );
 	renderSystem->executeResourceTransition( barrier );
 #endif
+
+	return true;
 }
@@ -0,0 +1,148 @@
+#include "ColibriGui/ColibriOffScreenCanvasScheduler.h"
+
+#include "ColibriGui/ColibriOffScreenCanvas.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace Colibri;
+
+OffScreenCanvasScheduler::OffScreenCanvasScheduler() :
+	m_maxRendersPerFrame( 0u ),
+	m_timeBudget( 0.0f ),
+	m_numDueLastFrame( 0u ),
+	m_numUpdatedLastFrame( 0u ),
+	m_numRenderedLastFrame( 0u )
+{
+}
+//-----------------------------------------------------------------------------
+OffScreenCanvasScheduler::CanvasEntryVec::iterator OffScreenCanvasScheduler::findCanvas(
+	OffScreenCanvas *canvas )
+{
+	CanvasEntryVec::iterator itor = m_canvases.begin();
+	CanvasEntryVec::iterator endt = m_canvases.end();
+
+	while( itor != endt && itor->canvas != canvas )
+		++itor;
+
+	return itor;
+}
+//-----------------------------------------------------------------------------
+static float refreshRateToPeriod( float refreshRate )
+{
+	return refreshRate > 0.0f ? ( 1.0f / refreshRate ) : 0.0f;
+}
+//-----------------------------------------------------------------------------
+void OffScreenCanvasScheduler::addCanvas( OffScreenCanvas *canvas, float refreshRate, float priority )
+{
+	COLIBRI_ASSERT_LOW( findCanvas( canvas ) == m_canvases.end() && "Canvas already registered!" );
+	COLIBRI_ASSERT_LOW( priority > 0.0f );
+
+	CanvasEntry entry;
+	entry.canvas = canvas;
+	entry.refreshPeriod = refreshRateToPeriod( refreshRate );
+	entry.priority = priority;
+	// Make it due right away, since it has never been drawn
+	entry.timeSinceUpdate = entry.refreshPeriod;
+	m_canvases.push_back( entry );
+}
+//-----------------------------------------------------------------------------
+void OffScreenCanvasScheduler::removeCanvas( OffScreenCanvas *canvas )
+{
+	CanvasEntryVec::iterator itor = findCanvas( canvas );
+	COLIBRI_ASSERT_LOW( itor != m_canvases.end() && "Canvas not registered!" );
+	if( itor != m_canvases.end() )
+		m_canvases.erase( itor );
+}
+//-----------------------------------------------------------------------------
+void OffScreenCanvasScheduler::setRefreshRate( OffScreenCanvas *canvas, float refreshRate )
+{
+	CanvasEntryVec::iterator itor = findCanvas( canvas );
+	COLIBRI_ASSERT_LOW( itor != m_canvases.end() && "Canvas not registered!" );
+	if( itor != m_canvases.end() )
+		itor->refreshPeriod = refreshRateToPeriod( refreshRate );
+}
+//-----------------------------------------------------------------------------
+void OffScreenCanvasScheduler::setPriority( OffScreenCanvas *canvas, float priority )
+{
+	COLIBRI_ASSERT_LOW( priority > 0.0f );
+	CanvasEntryVec::iterator itor = findCanvas( canvas );
+	COLIBRI_ASSERT_LOW( itor != m_canvases.end() && "Canvas not registered!" );
+	if( itor != m_canvases.end() )
+		itor->priority = priority;
+}
+//-----------------------------------------------------------------------------
+void OffScreenCanvasScheduler::scheduleUpdate( OffScreenCanvas *canvas )
+{
+	CanvasEntryVec::iterator itor = findCanvas( canvas );
+	COLIBRI_ASSERT_LOW( itor != m_canvases.end() && "Canvas not registered!" );
+	if( itor != m_canvases.end() )
+		itor->timeSinceUpdate = std::max( itor->timeSinceUpdate, itor->refreshPeriod );
+}
+//-----------------------------------------------------------------------------
+void OffScreenCanvasScheduler::setMaxRendersPerFrame( uint32_t maxRendersPerFrame )
+{
+	m_maxRendersPerFrame = maxRendersPerFrame;
+}
+//-----------------------------------------------------------------------------
+void OffScreenCanvasScheduler::setTimeBudget( float seconds ) { m_timeBudget = seconds; }
+//-----------------------------------------------------------------------------
+bool OffScreenCanvasScheduler::compareUrgency( const DueCanvas &a, const DueCanvas &b )
+{
+	return a.urgency > b.urgency;
+}
+//-----------------------------------------------------------------------------
+void OffScreenCanvasScheduler::update( float timeSinceLast )
+{
+	const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	m_dueCanvases.clear();
+
+	// Urgency grows the later a canvas is, relative to its own refresh period.
+	// Canvases that must update every frame use the frame time as their period.
+	const float minPeriod = std::max( timeSinceLast, 1e-6f );
+
+	const size_t numCanvases = m_canvases.size();
+	for( size_t i = 0u; i < numCanvases; ++i )
+	{
+		CanvasEntry &entry = m_canvases[i];
+		entry.timeSinceUpdate += timeSinceLast;
+		if( entry.timeSinceUpdate >= entry.refreshPeriod )
+		{
+			DueCanvas dueCanvas;
+			dueCanvas.urgency = entry.priority * entry.timeSinceUpdate /
+								std::max( entry.refreshPeriod, minPeriod );
+			dueCanvas.idx = i;
+			m_dueCanvases.push_back( dueCanvas );
+		}
+	}
+
+	std::sort( m_dueCanvases.begin(), m_dueCanvases.end(), compareUrgency );
+
+	m_numDueLastFrame = static_cast<uint32_t>( m_dueCanvases.size() );
+	m_numUpdatedLastFrame = 0u;
+	m_numRenderedLastFrame = 0u;
+
+	for( const DueCanvas &dueCanvas : m_dueCanvases )
+	{
+		if( m_numUpdatedLastFrame > 0u )
+		{
+			if( m_maxRendersPerFrame != 0u && m_numRenderedLastFrame >= m_maxRendersPerFrame )
+				break;
+
+			if( m_timeBudget > 0.0f )
+			{
+				const std::chrono::duration<float> elapsed =
+					std::chrono::steady_clock::now() - startTime;
+				if( elapsed.count() >= m_timeBudget )
+					break;
+			}
+		}
+
+		CanvasEntry &entry = m_canvases[dueCanvas.idx];
+		if( entry.canvas->updateCanvas( entry.timeSinceUpdate ) )
+			++m_numRenderedLastFrame;
+		++m_numUpdatedLastFrame;
+		entry.timeSinceUpdate = 0.0f;
+	}
+}
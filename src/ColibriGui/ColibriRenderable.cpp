@@ -31,19 +31,41 @@ namespace Colibri
 							   manager ),
 		m_overrideSkinColour( false ),
 		m_colour( Ogre::ColourValue::White ),
-		m_numVertices( 6u * 9u ),
+		m_numVertices( c_numNineSliceVertices ),
 		m_currVertexBufferOffset( 0 ),
+		m_visualsDirty( manager->_getVisualsDirtyFrameCount() ),
+		m_lastFillPassIdx( 0u ),
+		m_extraDrawParams( 0 ),
+		m_numExtraDrawParams( 0u ),
+		m_textDrawSlot( 0u ),
+		m_nextTextDrawSlot( 0u ),
 		m_visualsEnabled( true ),
+		m_nineSlicePerCell( false ),
 		m_ignoreParentClipBorder( false )
 	{
 		m_zOrder = _wrapZOrderInternalId( 0 );
 		memset( m_stateInformation, 0, sizeof( m_stateInformation ) );
+		memset( &m_drawParams, 0, sizeof( m_drawParams ) );
+		m_lastDrawnTopLeft = Ogre::Vector2::UNIT_SCALE;
+		m_lastDrawnBottomRight = -Ogre::Vector2::UNIT_SCALE;
 		for( size_t i = 0u; i < States::NumStates; ++i )
+		{
 			m_stateInformation[i].defaultColour = Ogre::ColourValue::White;
+			// Borders are 0, thus only the center cell is visible
+			m_stateInformation[i].sharedUvGrid = true;
+		}
+	}
+	//-------------------------------------------------------------------------
+	void Renderable::_destroy()
+	{
+		if( m_nineSlicePerCell )
+			m_manager->_addNineSlicesPerCellChange( -1 );
+		Widget::_destroy();
 	}
 	//-------------------------------------------------------------------------
 	void Renderable::_notifyCanvasChanged()
 	{
+		setVisualsDirty();
 		setClipBordersMatchSkin();
 		Widget::_notifyCanvasChanged();
 	}
@@ -53,9 +75,40 @@ namespace Colibri
 		setDatablock( m_stateInformation[newState].materialName );
 	}
 	//-------------------------------------------------------------------------
+	void Renderable::updateNineSliceLayout()
+	{
+		// Labels, LabelBmps & CustomShapes generate their own vertices
+		if( getWidgetRenderType() != WidgetRenderType::Normal || isLabelBmp() )
+			return;
+
+		const bool bPerCell = !m_stateInformation[m_currentState].sharedUvGrid;
+		if( m_nineSlicePerCell == bPerCell )
+			return;
+
+		m_nineSlicePerCell = bPerCell;
+		m_numVertices = bPerCell ? c_numNineSlicePerCellVertices : c_numNineSliceVertices;
+		m_manager->_addNineSlicesPerCellChange( bPerCell ? 1 : -1 );
+
+		// Not indexed, thus the vertex shader can't derive the drawId from the vertex ID.
+		// Draw like CustomShape does (see HlmsColibri::calculateHashForPreCreate)
+		if( bPerCell )
+			setCustomParameter( 6374, Ogre::Vector4( 1.0f ) );
+		else
+			removeCustomParameter( 6374 );
+
+		// setDatablock recalculates the Hlms hash, which picks up the change above
+		if( mHlmsDatablock )
+			setDatablock( mHlmsDatablock );
+
+		setVisualsDirty();
+	}
+	//-------------------------------------------------------------------------
 	void Renderable::setVisualsEnabled( bool bEnabled )
 	{
+		if( m_visualsEnabled != bEnabled )
+			m_manager->_notifyDrawListDirty();
 		m_visualsEnabled = bEnabled;
+		setVisualsDirty();
 	}
 	//-------------------------------------------------------------------------
 	bool Renderable::isVisualsEnabled() const
@@ -63,8 +116,152 @@ namespace Colibri
 		return m_visualsEnabled;
 	}
 	//-------------------------------------------------------------------------
+	void Renderable::setVisualsDirty()
+	{
+		m_visualsDirty = m_manager->_getVisualsDirtyFrameCount();
+		m_manager->_notifyDirtyRegion( this );
+	}
+	//-------------------------------------------------------------------------
+	bool Renderable::beginVisualsUpdate( uint32_t vertexBufferOffset )
+	{
+		const uint32_t fillPassIdx = m_manager->_getFillPassIdx();
+
+		// If our slot moved, or we weren't filled in the previous pass (i.e. we or one of
+		// our parents got culled, hidden, etc) then someone else may have written over our slot.
+		if( vertexBufferOffset != m_currVertexBufferOffset || m_lastFillPassIdx + 1u != fillPassIdx )
+		{
+			// Our looks didn't change, thus don't call setVisualsDirty (we may be running
+			// in parallel, and it would flag a dirty region)
+			m_currVertexBufferOffset = vertexBufferOffset;
+			m_visualsDirty = m_manager->_getVisualsDirtyFrameCount();
+		}
+
+		m_lastFillPassIdx = fillPassIdx;
+
+		if( m_visualsDirty )
+		{
+			--m_visualsDirty;
+			return true;
+		}
+
+		return m_manager->_getRewriteAllVertices();
+	}
+	//-------------------------------------------------------------------------
+	void Renderable::setExtraDrawParams( uint32_t const *colibri_nullable data, uint32_t numEntries )
+	{
+		COLIBRI_ASSERT_LOW(
+			( numEntries == 0u || getWidgetRenderType() == WidgetRenderType::CustomShape ) &&
+			"Only CustomShapes can have extra draw params" );
+		COLIBRI_ASSERT_LOW( ( data || numEntries == 0u ) && "data can't be null" );
+		m_extraDrawParams = data;
+		m_numExtraDrawParams = numEntries;
+	}
+	//-------------------------------------------------------------------------
+	static bool isIdentityRotation( const Matrix2x3 &m )
+	{
+		return m.m[0][0] == 1.0f && m.m[0][1] == 0.0f && m.m[1][0] == 0.0f && m.m[1][1] == 1.0f;
+	}
+	//-------------------------------------------------------------------------
+	void Renderable::updateDrawParams( const Ogre::Vector2 &clipTL, const Ogre::Vector2 &clipBR,
+									   bool bSnapToPixels )
+	{
+		Ogre::Vector2 posOffset( m_derivedScrollOffset.x,
+								 -m_derivedScrollOffset.y * m_manager->getCanvasAspectRatio() );
+		if( bSnapToPixels )
+		{
+			const Ogre::Vector2 halfWindowRes = m_manager->getHalfWindowResolution();
+			posOffset.x = roundf( posOffset.x * halfWindowRes.x ) / halfWindowRes.x;
+			posOffset.y = roundf( posOffset.y * halfWindowRes.y ) / halfWindowRes.y;
+		}
+		m_drawParams.posOffset[0] = posOffset.x;
+		m_drawParams.posOffset[1] = posOffset.y;
+
+		// Vertices store the distance to our own borders. Both our rect and
+		// the clip region are scrolled, so this is just a change of reference.
+		const Ogre::Vector2 invClipSize = 1.0f / ( clipBR - clipTL );
+		const Ogre::Vector2 clipRectSize = getVertexClipRectSize();
+		const Ogre::Vector2 clipRectBR = m_derivedTopLeft + clipRectSize;
+
+		m_drawParams.clipScale[0] = clipRectSize.x * invClipSize.x;
+		m_drawParams.clipScale[1] = clipRectSize.y * invClipSize.y;
+		m_drawParams.clipBias[Borders::Top] = ( m_derivedTopLeft.y - clipTL.y ) * invClipSize.y;
+		m_drawParams.clipBias[Borders::Left] = ( m_derivedTopLeft.x - clipTL.x ) * invClipSize.x;
+		m_drawParams.clipBias[Borders::Right] = ( clipBR.x - clipRectBR.x ) * invClipSize.x;
+		m_drawParams.clipBias[Borders::Bottom] = ( clipBR.y - clipRectBR.y ) * invClipSize.y;
+
+		if( m_manager->getDirtyRegionTracking() )
+		{
+			// Labels & CustomShapes can draw anywhere inside the clip region. Don't bother
+			// with the exact area of rotated widgets. Our rect & the clip region
+			// are already scrolled (posOffset only moves vertices back and forth).
+			if( !isIdentityRotation( m_derivedOrientation ) )
+			{
+				m_lastDrawnTopLeft = -Ogre::Vector2::UNIT_SCALE;
+				m_lastDrawnBottomRight = Ogre::Vector2::UNIT_SCALE;
+			}
+			else if( getWidgetRenderType() != WidgetRenderType::Normal || isLabelBmp() )
+			{
+				m_lastDrawnTopLeft = clipTL;
+				m_lastDrawnBottomRight = clipBR;
+			}
+			else
+			{
+				m_lastDrawnTopLeft = m_derivedTopLeft;
+				m_lastDrawnBottomRight = m_derivedBottomRight;
+				m_lastDrawnTopLeft.makeCeil( clipTL );
+				m_lastDrawnBottomRight.makeFloor( clipBR );
+			}
+		}
+	}
+	//-------------------------------------------------------------------------
+	void Renderable::_addToDirtyRegion( Ogre::Vector2 &inOutTopLeft,
+										Ogre::Vector2 &inOutBottomRight ) const
+	{
+		if( m_lastDrawnTopLeft.x < m_lastDrawnBottomRight.x &&
+			m_lastDrawnTopLeft.y < m_lastDrawnBottomRight.y )
+		{
+			inOutTopLeft.makeFloor( m_lastDrawnTopLeft );
+			inOutBottomRight.makeCeil( m_lastDrawnBottomRight );
+		}
+
+		// Where we'll be drawn next. Our clip region is only known while drawing.
+		// The clip region is always inside our parent, so use that instead.
+		// Use the getters: we or our parents may have been hidden or culled with a
+		// stale derived transform (see m_derivedTransformStale).
+		const Widget *bounds = this;
+		if( getWidgetRenderType() != WidgetRenderType::Normal || isLabelBmp() )
+			bounds = m_parent;
+
+		if( !bounds || !isIdentityRotation( getDerivedOrientation() ) )
+		{
+			inOutTopLeft = -Ogre::Vector2::UNIT_SCALE;
+			inOutBottomRight = Ogre::Vector2::UNIT_SCALE;
+			return;
+		}
+
+		// Derived rects already include the scroll of our windows
+		inOutTopLeft.makeFloor( bounds->getDerivedTopLeft() );
+		inOutBottomRight.makeCeil( bounds->getDerivedBottomRight() );
+	}
+	//-------------------------------------------------------------------------
+	Ogre::Vector2 Renderable::getVertexClipRectSize() const
+	{
+		Ogre::Vector2 clipRectSize = m_derivedBottomRight - m_derivedTopLeft;
+		clipRectSize.makeCeil( m_manager->getPixelSize2x() );
+		return clipRectSize;
+	}
+	//-------------------------------------------------------------------------
+	Matrix2x3 Renderable::getVertexOrientation() const
+	{
+		Matrix2x3 retVal = m_derivedOrientation;
+		retVal.m[0][2] -= m_drawParams.posOffset[0];
+		retVal.m[1][2] += m_drawParams.posOffset[1] * m_manager->getCanvasInvAspectRatio();
+		return retVal;
+	}
+	//-------------------------------------------------------------------------
 	void Renderable::setColour( bool overrideSkinColour, const Ogre::ColourValue &colour )
 	{
+		setVisualsDirty();
 		m_overrideSkinColour = overrideSkinColour;
 		if( overrideSkinColour )
 			m_colour = colour;
@@ -101,6 +298,8 @@ namespace Colibri
 		if( !m_overrideSkinColour )
 			m_colour = m_stateInformation[m_currentState].defaultColour;
 
+		updateNineSliceLayout();
+		setVisualsDirty();
 		setClipBordersMatchSkin();
 	}
 	//-------------------------------------------------------------------------
@@ -139,26 +338,39 @@ namespace Colibri
 		if( !m_overrideSkinColour )
 			m_colour = m_stateInformation[m_currentState].defaultColour;
 
+		updateNineSliceLayout();
+		setVisualsDirty();
 		setClipBordersMatchSkin();
 	}
 	//-------------------------------------------------------------------------
+	static void setStateBorderSize( StateInformation &stateInfo,
+									const float borderSize[colibri_nonnull Borders::NumBorders] )
+	{
+		for( size_t j = 0u; j < Borders::NumBorders; ++j )
+		{
+			// A border that was 0 reveals cells whose UVs SkinManager never checked
+			if( stateInfo.borderSize[j] == 0.0f && borderSize[j] != 0.0f )
+				stateInfo.sharedUvGrid = false;
+			stateInfo.borderSize[j] = borderSize[j];
+		}
+	}
+	//-------------------------------------------------------------------------
 	void Renderable::setBorderSize( const float borderSize[colibri_nonnull Borders::NumBorders],
 									States::States forState, bool bClipBordersMatchSkin )
 	{
 		if( forState == States::NumStates )
 		{
 			for( size_t i = 0u; i < States::NumStates; ++i )
-			{
-				for( size_t j = 0u; j < Borders::NumBorders; ++j )
-					m_stateInformation[i].borderSize[j] = borderSize[j];
-			}
+				setStateBorderSize( m_stateInformation[i], borderSize );
 		}
 		else
 		{
-			for( size_t j = 0u; j < Borders::NumBorders; ++j )
-				m_stateInformation[forState].borderSize[j] = borderSize[j];
+			setStateBorderSize( m_stateInformation[forState], borderSize );
 		}
 
+		updateNineSliceLayout();
+		setVisualsDirty();
+
 		if( bClipBordersMatchSkin )
 			setClipBordersMatchSkin();
 	}
@@ -193,6 +405,8 @@ namespace Colibri
 		if( !m_overrideSkinColour )
 			m_colour = m_stateInformation[m_currentState].defaultColour;
 
+		updateNineSliceLayout();
+		setVisualsDirty();
 		setClipBordersMatchSkin();
 	}
 	//-------------------------------------------------------------------------
@@ -206,9 +420,17 @@ namespace Colibri
 		if( mHlmsDatablock->getName() != m_stateInformation[m_currentState].materialName )
 			setDatablock( m_stateInformation[m_currentState].materialName );
 
+		updateNineSliceLayout();
+		setVisualsDirty();
 		setClipBordersMatchSkin();
 	}
 	//-------------------------------------------------------------------------
+	void Renderable::setTransformDirty( uint32_t dirtyReason )
+	{
+		setVisualsDirty();
+		Widget::setTransformDirty( dirtyReason );
+	}
+	//-------------------------------------------------------------------------
 	void Renderable::setClipBordersMatchSkin()
 	{
 		setClipBordersMatchSkin( m_currentState );
@@ -228,10 +450,47 @@ namespace Colibri
 		setClipBorders( clipBorders );
 	}
 	//-------------------------------------------------------------------------
-	void Renderable::broadcastNewVao( Ogre::VertexArrayObject *vao, Ogre::VertexArrayObject *textVao )
+	void Renderable::_discardEmptyDraw( ApiEncapsulatedObjects &apiObject )
 	{
-		setVao( !isLabel() ? vao : textVao );
-		Widget::broadcastNewVao( vao, textVao );
+		if( apiObject.drawCountPtr && *apiObject.drawCountPtr == 0u )
+		{
+			// Adreno 618 will GPU crash if we send an indirect cmd with vertex_count = 0
+			--apiObject.drawCmd->numDraws;
+			// Take back the last indirect draw. Its type depends on the current draw cmd.
+			apiObject.indirectDraw -= apiObject.drawCmdIndexed ? sizeof( Ogre::CbDrawIndexed )
+															   : sizeof( Ogre::CbDrawStrip );
+		}
+	}
+	//-------------------------------------------------------------------------
+	/// Adds a new indirect draw to apiObject.drawCmd (does not increment numDraws)
+	static void addIndirectDraw( ApiEncapsulatedObjects &apiObject, Ogre::uint32 firstVertex,
+								 Ogre::uint32 firstIndex, Ogre::uint32 baseInstance )
+	{
+		using namespace Ogre;
+
+		apiObject.primCount = 0;
+
+		if( apiObject.drawCmdIndexed )
+		{
+			CbDrawIndexed *drawIndexed = reinterpret_cast<CbDrawIndexed *>( apiObject.indirectDraw );
+			drawIndexed->primCount = 0;
+			drawIndexed->instanceCount = 1u;
+			drawIndexed->firstVertexIndex = firstIndex;
+			drawIndexed->baseVertex = firstVertex;
+			drawIndexed->baseInstance = baseInstance;
+			apiObject.drawCountPtr = &drawIndexed->primCount;
+			apiObject.indirectDraw += sizeof( CbDrawIndexed );
+		}
+		else
+		{
+			CbDrawStrip *drawStrip = reinterpret_cast<CbDrawStrip *>( apiObject.indirectDraw );
+			drawStrip->primCount = 0;
+			drawStrip->instanceCount = 1u;
+			drawStrip->firstVertexIndex = firstVertex;
+			drawStrip->baseInstance = baseInstance;
+			apiObject.drawCountPtr = &drawStrip->primCount;
+			apiObject.indirectDraw += sizeof( CbDrawStrip );
+		}
 	}
 	//-------------------------------------------------------------------------
 	void Renderable::_addCommands( ApiEncapsulatedObjects &apiObject, bool collectingBreadthFirst )
@@ -239,6 +498,16 @@ namespace Colibri
 		if( m_culled )
 			return;
 
+		if( apiObject.drawList )
+			apiObject.drawList->push_back( this );
+
+		_addDrawCommands( apiObject );
+
+		addChildrenCommands( apiObject, collectingBreadthFirst );
+	}
+	//-------------------------------------------------------------------------
+	void Renderable::_addDrawCommands( ApiEncapsulatedObjects &apiObject )
+	{
 		if( m_visualsEnabled )
 		{
 			using namespace Ogre;
@@ -248,7 +517,6 @@ namespace Colibri
 			QueuedRenderable queuedRenderable( 0u, this, this );
 
 			uint32 lastHlmsCacheHash = apiObject.lastHlmsCache->hash;
-			VertexArrayObject *vao = mVaoPerLod[0].back();
 			const HlmsCache *hlmsCache = apiObject.hlms->getMaterial(
 				apiObject.lastHlmsCache, *apiObject.passCache, queuedRenderable, false
 #if OGRE_VERSION >= OGRE_MAKE_VERSION( 4, 0, 0 )
@@ -269,39 +537,47 @@ namespace Colibri
 			const WidgetRenderType::WidgetRenderType widgetRenderType = getWidgetRenderType();
 			const bool bIsLabel = widgetRenderType == WidgetRenderType::Label;
 			const size_t widgetType = bIsLabel ? 1u : 0u;
+			// mVaoPerLod only describes the vertex format. Draw from the manager's current Vao
+			VertexArrayObject *vao = apiObject.vao[widgetType];
+			// 9-slices & Label's glyphs are indexed. LabelBmp & CustomShape have arbitrary
+			// vertex counts. 9-slices with 6 vertices per cell are drawn like CustomShapes.
+			const bool bIndexed = widgetRenderType != WidgetRenderType::CustomShape &&
+								  !isLabelBmp() && !m_nineSlicePerCell;
 
 			const uint32 firstVertex = m_currVertexBufferOffset + apiObject.basePrimCount[widgetType];
+			const uint32 firstIndex =
+				bIndexed ? static_cast<uint32>( vao->getIndexBuffer()->_getFinalBufferStart() ) : 0u;
+
+			// Text only needs firstVertex modulo 4 (glyph corner), thus the upper bits hold our
+			// draw slot. Labels chained after us use it as reference. See m_textDrawSlot
+			const uint32 instanceBaseVertex =
+				bIsLabel ? ( uint32( m_textDrawSlot ) << 2u ) | ( firstVertex & 0x03u ) : firstVertex;
 
 			uint32 baseInstance = apiObject.hlms->fillBuffersForColibri(
 									  hlmsCache, queuedRenderable, false,
-									  firstVertex,
-									  lastHlmsCacheHash, apiObject.commandBuffer );
-
-			// Note: CustomShapes can't be chained from/to anything because they break the assumption
-			// each widget is 54 vertices; not even two CustomShapes can be instanced together.
-			// That assumption is necessary for instancing to properly address the right material.
+									  instanceBaseVertex, lastHlmsCacheHash,
+									  reinterpret_cast<const float *>( &m_drawParams ),
+									  m_extraDrawParams, m_numExtraDrawParams,
+									  apiObject.commandBuffer );
+
+			// Note: CustomShapes & LabelBmp can't be chained from/to anything because they break
+			// the assumption each widget is c_numNineSliceVertices; not even two CustomShapes can be
+			// instanced together. That assumption is necessary for instancing to properly address
+			// the right material.
 			//
-			// If previous widgetRenderType was WidgetRenderType::CustomShape and now we're not;
-			// then apiObject.drawCmd will be different because HlmsColibri::calculateHashForPreCreate
-			// makes sure a different shader is assigned for CustomShape and its derived classes
-			// (and fillBuffersForColibri was thus forced to add a command).
+			// They're not indexed, thus switching between them and regular widgets always
+			// creates a new draw command (CbDrawCallStrip vs CbDrawCallIndexed).
+			// HlmsColibri::calculateHashForPreCreate also makes sure a different shader is
+			// assigned for them (and fillBuffersForColibri was thus forced to add a command).
 			// Thus we will enter the if() block as intended.
 			//
-			// If the current widgetRenderType is WidgetRenderType::CustomShape then we will enter the
+			// If the current widget is a CustomShape or LabelBmp then we will enter the
 			// if block too because we specifically test for it. We don't have to reset all commands,
 			// we just need to move the drawId in the vertex shader to index the right material.
 			if( apiObject.drawCmd != commandBuffer->getLastCommand() ||
-				apiObject.lastVaoName != vao->getVaoName() )
+				apiObject.lastVaoName != vao->getVaoName() || apiObject.drawCmdIndexed != bIndexed )
 			{
-				if( apiObject.drawCountPtr && apiObject.drawCountPtr->primCount == 0u )
-				{
-					// Adreno 618 will GPU crash if we send an indirect cmd with vertex_count = 0
-					--apiObject.drawCmd->numDraws;
-					// Since we only emit CbDrawStrip we can assume the previous cmd
-					// issued a CbDrawStrip, so take it back. Otherwise we'd have to
-					// save what our last cmd was.
-					apiObject.indirectDraw -= sizeof( CbDrawStrip );
-				}
+				_discardEmptyDraw( apiObject );
 
 				{
 					*commandBuffer->addCommand<CbVao>() = CbVao( vao );
@@ -314,82 +590,121 @@ namespace Colibri
 					ptrdiff_t( apiObject.indirectBuffer->_getFinalBufferStart() ) +
 					( apiObject.indirectDraw - apiObject.startIndirectDraw ) );
 
-				CbDrawCallStrip *drawCall = commandBuffer->addCommand<CbDrawCallStrip>();
-				*drawCall = CbDrawCallStrip( apiObject.baseInstanceAndIndirectBuffers, vao, offset );
-				drawCall->numDraws = 1u;
-				apiObject.drawCmd = drawCall;
-				apiObject.primCount = 0;
+				if( bIndexed )
+				{
+					CbDrawCallIndexed *drawCall = commandBuffer->addCommand<CbDrawCallIndexed>();
+					*drawCall =
+						CbDrawCallIndexed( apiObject.baseInstanceAndIndirectBuffers, vao, offset );
+					apiObject.drawCmd = drawCall;
+				}
+				else
+				{
+					CbDrawCallStrip *drawCall = commandBuffer->addCommand<CbDrawCallStrip>();
+					*drawCall =
+						CbDrawCallStrip( apiObject.baseInstanceAndIndirectBuffers, vao, offset );
+					apiObject.drawCmd = drawCall;
+				}
+				apiObject.drawCmd->numDraws = 1u;
+				apiObject.drawCmdIndexed = bIndexed;
 				apiObject.lastDatablock = mHlmsDatablock;
 
-				apiObject.drawCountPtr = reinterpret_cast<CbDrawStrip*>( apiObject.indirectDraw );
-				apiObject.drawCountPtr->primCount		= 0;
-				apiObject.drawCountPtr->instanceCount	= 1u;
-				apiObject.drawCountPtr->firstVertexIndex= firstVertex;
-				apiObject.drawCountPtr->baseInstance	= baseInstance;
-				apiObject.indirectDraw += sizeof( CbDrawStrip );
+				addIndirectDraw( apiObject, firstVertex, firstIndex, baseInstance );
+				apiObject.textChainLength = 0u;
 			}
-			else if( bIsLabel && apiObject.lastDatablock != mHlmsDatablock )
+			else if( bIsLabel )
 			{
-				if( apiObject.drawCountPtr && apiObject.drawCountPtr->primCount == 0u )
+				// Text has arbitrary number of of vertices, thus the vertex shader can't calculate
+				// the drawId (and therefore the material ID & DrawParams) from the vertex ID.
+				// Instead it uses the slot baked into our vertices, relative to the slot of the
+				// first Label in the draw; which only works if our instance data comes right
+				// after the previous Label's and our vertices too.
+				const bool bCanChain = apiObject.textChainLength != 0u &&
+									   apiObject.textChainLength < 0xFFFFu &&
+									   apiObject.nextFirstVertex == firstVertex;
+
+				if( bCanChain && m_textDrawSlot == uint16_t( apiObject.textDrawSlot + 1u ) )
 				{
-					// Adreno 618 will GPU crash if we send an indirect cmd with vertex_count = 0
-					--apiObject.drawCmd->numDraws;
-					// Since we only emit CbDrawStrip we can assume the previous cmd
-					// issued a CbDrawStrip, so take it back. Otherwise we'd have to
-					// save what our last cmd was.
-					apiObject.indirectDraw -= sizeof( CbDrawStrip );
+					++apiObject.textChainLength;
+				}
+				else
+				{
+					_discardEmptyDraw( apiObject );
+
+					++apiObject.drawCmd->numDraws;
+					addIndirectDraw( apiObject, firstVertex, firstIndex, baseInstance );
+					apiObject.textChainLength = 0u;
 				}
 
-				//Text has arbitrary number of of vertices, thus we can't properly calculate the drawId
-				//and therefore the material ID unless we issue a start a new draw.
-				CbDrawCallStrip *drawCall = static_cast<CbDrawCallStrip*>( apiObject.drawCmd );
-				++drawCall->numDraws;
-				apiObject.primCount = 0;
 				apiObject.lastDatablock = mHlmsDatablock;
 
-				apiObject.drawCountPtr = reinterpret_cast<CbDrawStrip*>( apiObject.indirectDraw );
-				apiObject.drawCountPtr->primCount		= 0;
-				apiObject.drawCountPtr->instanceCount	= 1u;
-				apiObject.drawCountPtr->firstVertexIndex= firstVertex;
-				apiObject.drawCountPtr->baseInstance	= baseInstance;
-				apiObject.indirectDraw += sizeof( CbDrawStrip );
-			}
-			else if( apiObject.nextFirstVertex != firstVertex ||
-					 widgetRenderType == WidgetRenderType::CustomShape )
-			{
-				if( apiObject.drawCountPtr && apiObject.drawCountPtr->primCount == 0u )
+				if( bCanChain &&
+					m_nextTextDrawSlot != uint16_t( apiObject.nextTextDrawSlot + 1u ) )
 				{
-					// Adreno 618 will GPU crash if we send an indirect cmd with vertex_count = 0
-					--apiObject.drawCmd->numDraws;
-					// Since we only emit CbDrawStrip we can assume the previous cmd
-					// issued a CbDrawStrip, so take it back. Otherwise we'd have to
-					// save what our last cmd was.
-					apiObject.indirectDraw -= sizeof( CbDrawStrip );
+					// Our vertices have the wrong slot. Regenerate them so we get chained in the
+					// next frames. Don't call setVisualsDirty: our looks didn't change.
+					m_nextTextDrawSlot = uint16_t( apiObject.nextTextDrawSlot + 1u );
+					m_visualsDirty = m_manager->_getVisualsDirtyFrameCount();
 				}
+			}
+			else if( apiObject.nextFirstVertex != firstVertex || !bIndexed )
+			{
+				_discardEmptyDraw( apiObject );
 
 				//If we're here, we're most likely rendering using breadth first.
 				//Unfortunately, breadth first breaks ordering, thus firstVertex jumped.
 				//Add a new draw without creating a new command
-				CbDrawCallStrip *drawCall = static_cast<CbDrawCallStrip*>( apiObject.drawCmd );
-				++drawCall->numDraws;
-				apiObject.primCount = 0;
+				++apiObject.drawCmd->numDraws;
 				apiObject.lastDatablock = mHlmsDatablock;
 
-				apiObject.drawCountPtr = reinterpret_cast<CbDrawStrip*>( apiObject.indirectDraw );
-				apiObject.drawCountPtr->primCount		= 0;
-				apiObject.drawCountPtr->instanceCount	= 1u;
-				apiObject.drawCountPtr->firstVertexIndex= firstVertex;
-				apiObject.drawCountPtr->baseInstance	= baseInstance;
-				apiObject.indirectDraw += sizeof( CbDrawStrip );
+				addIndirectDraw( apiObject, firstVertex, firstIndex, baseInstance );
 			}
 
-			apiObject.primCount += m_numVertices;
-			apiObject.drawCountPtr->primCount = apiObject.primCount;
+			// A Label with extra params takes more instance entries than the vertex shader
+			// expects, thus nothing can be chained after it.
+			if( bIsLabel && m_numExtraDrawParams == 0u )
+			{
+				if( apiObject.textChainLength == 0u )
+					apiObject.textChainLength = 1u;
+				apiObject.textDrawSlot = m_textDrawSlot;
+				apiObject.nextTextDrawSlot = m_nextTextDrawSlot;
+			}
+			else
+			{
+				apiObject.textChainLength = 0u;
+			}
+
+			if( bIndexed )
+			{
+				const uint32 verticesPerPrim = bIsLabel ? c_numGlyphVertices : c_numNineSliceVertices;
+				const uint32 indicesPerPrim = bIsLabel ? c_numGlyphIndices : c_numNineSliceIndices;
+				const uint32 maxIndicesPerDraw = ( 65536u / verticesPerPrim ) * indicesPerPrim;
+
+				uint32 numIndices = ( m_numVertices / verticesPerPrim ) * indicesPerPrim;
+				uint32 drawFirstVertex = firstVertex;
+
+				// Indices are 16-bit. Once a draw addresses all the vertices it can, continue in
+				// a new draw (a long Label may need several of them).
+				while( apiObject.primCount + numIndices > maxIndicesPerDraw )
+				{
+					const uint32 indicesLeft = maxIndicesPerDraw - apiObject.primCount;
+					*apiObject.drawCountPtr = maxIndicesPerDraw;
+					numIndices -= indicesLeft;
+					drawFirstVertex += ( indicesLeft / indicesPerPrim ) * verticesPerPrim;
+
+					++apiObject.drawCmd->numDraws;
+					addIndirectDraw( apiObject, drawFirstVertex, firstIndex, baseInstance );
+				}
+
+				apiObject.primCount += numIndices;
+			}
+			else
+			{
+				apiObject.primCount += m_numVertices;
+			}
+			*apiObject.drawCountPtr = apiObject.primCount;
 
 			apiObject.nextFirstVertex = firstVertex + m_numVertices;
 		}
-
-		addChildrenCommands( apiObject, collectingBreadthFirst );
 	}
 	//-------------------------------------------------------------------------
 	const StateInformation& Renderable::getStateInformation( States::States state ) const
@@ -399,6 +714,13 @@ namespace Colibri
 		return m_stateInformation[state];
 	}
 	//-------------------------------------------------------------------------
+	void Renderable::_getVertexCountUpperBound( size_t &inOutNumVertices,
+												size_t &inOutNumTextVertices ) const
+	{
+		inOutNumVertices += m_numVertices;
+		Widget::_getVertexCountUpperBound( inOutNumVertices, inOutNumTextVertices );
+	}
+	//-------------------------------------------------------------------------
 	void Renderable::_fillBuffersAndCommands( UiVertex * colibri_nonnull * colibri_nonnull
 											 RESTRICT_ALIAS vertexBuffer,
 											 GlyphVertex * colibri_nonnull * colibri_nonnull
@@ -7,6 +7,13 @@
 
 #include "OgreBitwise.h"
 
+#if COLIBRI_SIMD_SSE2
+#	include <emmintrin.h>
+#elif COLIBRI_SIMD_NEON
+#	include <arm_neon.h>
+#endif
+#include <string.h>
+
 #define TODO_borderRepeatSize
 #define TODO_this_is_a_workaround_neg_y
 
@@ -93,6 +100,175 @@ namespace Colibri
 		#undef COLIBRI_ADD_VERTEX
 	}
 	//-------------------------------------------------------------------------
+	inline void Renderable::addNineSlice( UiVertex * RESTRICT_ALIAS vertexBuffer,
+										  const float gridX[colibri_nonnull 4],
+										  const float gridY[colibri_nonnull 4],
+										  const Ogre::Vector4 *colibri_nonnull uvTopLeftBottomRight,
+										  const uint8_t *colibri_nonnull rgbaColour,
+										  Ogre::Vector2 parentDerivedTL,
+										  Ogre::Vector2 parentDerivedBR,
+										  Ogre::Vector2 invSize,
+										  float canvasAspectRatio,
+										  float invCanvasAspectRatio,
+										  const Matrix2x3 &derivedRot )
+	{
+		TODO_this_is_a_workaround_neg_y;
+
+		static_assert( COLIBRI_COMPACT_VERTICES || sizeof( UiVertex ) == 32u,
+					   "Vertex writes below assume UiVertex layout" );
+
+		// Same layout as bytes [8; 16) of UiVertex
+		struct UvColour
+		{
+			uint16_t u;
+			uint16_t v;
+			uint8_t rgbaColour[4];
+		};
+
+		// The 16 corners of the grid, row major. This is also the order in which they're written.
+		alignas( 16 ) float cornerPos[16][2];
+		alignas( 16 ) float cornerClip[16][Borders::NumBorders];
+		alignas( 8 ) UvColour cornerUvColour[16];
+
+#if COLIBRI_SIMD_SSE2
+		{
+			const __m128 vX = _mm_loadu_ps( gridX );
+			const __m128 m00 = _mm_set1_ps( derivedRot.m[0][0] );
+			const __m128 m01 = _mm_set1_ps( derivedRot.m[0][1] );
+			const __m128 m02 = _mm_set1_ps( derivedRot.m[0][2] );
+			const __m128 m10 = _mm_set1_ps( derivedRot.m[1][0] );
+			const __m128 m11 = _mm_set1_ps( derivedRot.m[1][1] );
+			const __m128 m12 = _mm_set1_ps( derivedRot.m[1][2] );
+			const __m128 vAspectRatio = _mm_set1_ps( canvasAspectRatio );
+			const __m128 vNegZero = _mm_set1_ps( -0.0f );
+
+			for( size_t row = 0u; row < 4u; ++row )
+			{
+				// Same operation order as Widget::mul so results are bit exact
+				const __m128 vY = _mm_set1_ps( gridY[row] * invCanvasAspectRatio );
+				const __m128 posX =
+					_mm_add_ps( _mm_add_ps( _mm_mul_ps( m00, vX ), _mm_mul_ps( m01, vY ) ), m02 );
+				__m128 posY =
+					_mm_add_ps( _mm_add_ps( _mm_mul_ps( m10, vX ), _mm_mul_ps( m11, vY ) ), m12 );
+				posY = _mm_xor_ps( _mm_mul_ps( posY, vAspectRatio ), vNegZero );
+
+				_mm_store_ps( cornerPos[row * 4u + 0u], _mm_unpacklo_ps( posX, posY ) );
+				_mm_store_ps( cornerPos[row * 4u + 2u], _mm_unpackhi_ps( posX, posY ) );
+			}
+		}
+#elif COLIBRI_SIMD_NEON
+		{
+			const float32x4_t vX = vld1q_f32( gridX );
+			const float32x4_t m00 = vdupq_n_f32( derivedRot.m[0][0] );
+			const float32x4_t m01 = vdupq_n_f32( derivedRot.m[0][1] );
+			const float32x4_t m02 = vdupq_n_f32( derivedRot.m[0][2] );
+			const float32x4_t m10 = vdupq_n_f32( derivedRot.m[1][0] );
+			const float32x4_t m11 = vdupq_n_f32( derivedRot.m[1][1] );
+			const float32x4_t m12 = vdupq_n_f32( derivedRot.m[1][2] );
+			const float32x4_t vAspectRatio = vdupq_n_f32( canvasAspectRatio );
+
+			for( size_t row = 0u; row < 4u; ++row )
+			{
+				// Not using vmlaq_f32 on purpose, to keep the same rounding as Widget::mul
+				const float32x4_t vY = vdupq_n_f32( gridY[row] * invCanvasAspectRatio );
+				float32x4x2_t posXY;
+				posXY.val[0] =
+					vaddq_f32( vaddq_f32( vmulq_f32( m00, vX ), vmulq_f32( m01, vY ) ), m02 );
+				posXY.val[1] =
+					vaddq_f32( vaddq_f32( vmulq_f32( m10, vX ), vmulq_f32( m11, vY ) ), m12 );
+				posXY.val[1] = vnegq_f32( vmulq_f32( posXY.val[1], vAspectRatio ) );
+				vst2q_f32( cornerPos[row * 4u], posXY );
+			}
+		}
+#else
+		for( size_t row = 0u; row < 4u; ++row )
+		{
+			for( size_t col = 0u; col < 4u; ++col )
+			{
+				const Ogre::Vector2 pos =
+					Widget::mul( derivedRot, gridX[col], gridY[row] * invCanvasAspectRatio );
+				cornerPos[row * 4u + col][0] = pos.x;
+				cornerPos[row * 4u + col][1] = -( pos.y * canvasAspectRatio );
+			}
+		}
+#endif
+
+		{
+			// The skin has a StateInformation::sharedUvGrid, thus the corner cells
+			// and the center one are enough to know the whole UV grid.
+			const Ogre::Vector4 &uvTopLeft = uvTopLeftBottomRight[GridLocations::TopLeft];
+			const Ogre::Vector4 &uvCenter = uvTopLeftBottomRight[GridLocations::Center];
+			const Ogre::Vector4 &uvBottomRight = uvTopLeftBottomRight[GridLocations::BottomRight];
+			const uint16_t u[4] = { static_cast<uint16_t>( uvTopLeft.x * 65535.0f ),
+									static_cast<uint16_t>( uvCenter.x * 65535.0f ),
+									static_cast<uint16_t>( uvCenter.z * 65535.0f ),
+									static_cast<uint16_t>( uvBottomRight.z * 65535.0f ) };
+			const uint16_t v[4] = { static_cast<uint16_t>( uvTopLeft.y * 65535.0f ),
+									static_cast<uint16_t>( uvCenter.y * 65535.0f ),
+									static_cast<uint16_t>( uvCenter.w * 65535.0f ),
+									static_cast<uint16_t>( uvBottomRight.w * 65535.0f ) };
+
+			float clipLeft[4];
+			float clipRight[4];
+			for( size_t col = 0u; col < 4u; ++col )
+			{
+				clipLeft[col] = ( gridX[col] - parentDerivedTL.x ) * invSize.x;
+				clipRight[col] = ( parentDerivedBR.x - gridX[col] ) * invSize.x;
+			}
+
+			for( size_t row = 0u; row < 4u; ++row )
+			{
+				const float clipTop = ( gridY[row] - parentDerivedTL.y ) * invSize.y;
+				const float clipBottom = ( parentDerivedBR.y - gridY[row] ) * invSize.y;
+				for( size_t col = 0u; col < 4u; ++col )
+				{
+					const size_t corner = row * 4u + col;
+
+					float *clipDistance = cornerClip[corner];
+					clipDistance[Borders::Top] = clipTop;
+					clipDistance[Borders::Left] = clipLeft[col];
+					clipDistance[Borders::Right] = clipRight[col];
+					clipDistance[Borders::Bottom] = clipBottom;
+
+					cornerUvColour[corner].u = u[col];
+					cornerUvColour[corner].v = v[row];
+					memcpy( cornerUvColour[corner].rgbaColour, rgbaColour,
+							sizeof( cornerUvColour[corner].rgbaColour ) );
+				}
+			}
+		}
+
+		for( size_t corner = 0u; corner < 16u; ++corner )
+		{
+#if COLIBRI_SIMD_SSE2 && !COLIBRI_COMPACT_VERTICES
+			const __m128i lo = _mm_unpacklo_epi64(
+				_mm_loadl_epi64( reinterpret_cast<const __m128i *>( cornerPos[corner] ) ),
+				_mm_loadl_epi64( reinterpret_cast<const __m128i *>( &cornerUvColour[corner] ) ) );
+			const __m128i hi = _mm_load_si128( reinterpret_cast<const __m128i *>( cornerClip[corner] ) );
+			// No streaming stores: Benchmarks/NineSlice.cpp showed them to be ~3x slower
+			// when the vertex buffer lives in cacheable memory
+			__m128i *dst = reinterpret_cast<__m128i *>( vertexBuffer );
+			_mm_storeu_si128( dst, lo );
+			_mm_storeu_si128( dst + 1u, hi );
+#elif COLIBRI_SIMD_NEON && !COLIBRI_COMPACT_VERTICES
+			const uint32x4_t lo = vcombine_u32(
+				vld1_u32( reinterpret_cast<const uint32_t *>( cornerPos[corner] ) ),
+				vld1_u32( reinterpret_cast<const uint32_t *>( &cornerUvColour[corner] ) ) );
+			const uint32x4_t hi = vld1q_u32( reinterpret_cast<const uint32_t *>( cornerClip[corner] ) );
+			uint32_t *dst = reinterpret_cast<uint32_t *>( vertexBuffer );
+			vst1q_u32( dst, lo );
+			vst1q_u32( dst + 4u, hi );
+#else
+			vertexBuffer->x = cornerPos[corner][0];
+			vertexBuffer->y = cornerPos[corner][1];
+			memcpy( &vertexBuffer->u, &cornerUvColour[corner], sizeof( UvColour ) );
+			for( size_t i = 0u; i < Borders::NumBorders; ++i )
+				vertexBuffer->clipDistance[i] = cornerClip[corner][i];
+#endif
+			++vertexBuffer;
+		}
+	}
+	//-------------------------------------------------------------------------
 	inline void Renderable::_fillBuffersAndCommands( UiVertex * colibri_nonnull * colibri_nonnull
 													 RESTRICT_ALIAS _vertexBuffer,
 													 GlyphVertex * colibri_nonnull * colibri_nonnull
@@ -105,22 +281,14 @@ namespace Colibri
 	{
 		UiVertex * RESTRICT_ALIAS vertexBuffer = *_vertexBuffer;
 
-		updateDerivedTransform( parentPos, parentRot );
-
-		m_culled = true;
-
+		bool bCulled;
 		if( forWindows )
-		{
-			if( (m_parent && !m_parent->intersectsChild( this, parentScrollPos )) || m_hidden )
-				return;
-		}
+			bCulled = ( m_parent && !m_parent->intersectsChild( this, parentScrollPos ) ) || m_hidden;
 		else
-		{
-			if( !m_parent->intersectsChild( this, parentScrollPos ) || m_hidden )
-				return;
-		}
+			bCulled = !m_parent->intersectsChild( this, parentScrollPos ) || m_hidden;
 
-		m_culled = false;
+		if( setCulledAndUpdateDerivedTransform( bCulled, parentPos, parentRot ) )
+			return;
 
 		Ogre::Vector2 parentDerivedTL;
 		Ogre::Vector2 parentDerivedBR;
@@ -154,18 +322,26 @@ namespace Colibri
 
 		const Ogre::Vector2 outerTopLeft = this->m_derivedTopLeft;
 
-		if( m_visualsEnabled )
-		{
-			m_currVertexBufferOffset =
-				static_cast<uint32_t>( vertexBuffer - m_manager->_getVertexBufferBase() );
+		updateDrawParams( parentDerivedTL, parentDerivedBR );
 
+		const uint32_t vertexBufferOffset =
+			static_cast<uint32_t>( vertexBuffer - m_manager->_getVertexBufferBase() );
+
+		if( m_visualsEnabled && !beginVisualsUpdate( vertexBufferOffset ) )
+		{
+			// Retained mode: Vertices from previous frames are still valid.
+			*_vertexBuffer = vertexBuffer + m_numVertices;
+		}
+		else if( m_visualsEnabled )
+		{
 			uint8_t rgbaColour[4];
 			rgbaColour[0] = static_cast<uint8_t>( m_colour.r * 255.0f + 0.5f );
 			rgbaColour[1] = static_cast<uint8_t>( m_colour.g * 255.0f + 0.5f );
 			rgbaColour[2] = static_cast<uint8_t>( m_colour.b * 255.0f + 0.5f );
 			rgbaColour[3] = static_cast<uint8_t>( m_colour.a * 255.0f + 0.5f );
 
-			const Ogre::Vector2 invSize = 1.0f / (parentDerivedBR - parentDerivedTL);
+			const Ogre::Vector2 clipRectSize = getVertexClipRectSize();
+			const Ogre::Vector2 invSize = 1.0f / clipRectSize;
 
 			const Ogre::Vector2 outerBottomRight	= this->m_derivedBottomRight;
 
@@ -188,73 +364,38 @@ namespace Colibri
 			const float canvasAr = m_manager->getCanvasAspectRatio();
 			const float invCanvasAr = m_manager->getCanvasInvAspectRatio();
 
-			// 1st row
-			addQuad( vertexBuffer,                                           //
-					 outerTopLeft, innerTopLeft,                             //
-					 stateInfo.uvTopLeftBottomRight[0],                      //
-					 rgbaColour, parentDerivedTL, parentDerivedBR, invSize,  //
-					 canvasAr, invCanvasAr, this->m_derivedOrientation );
-			vertexBuffer += 6u;
-			addQuad( vertexBuffer,                                           //
-					 Ogre::Vector2( innerTopLeft.x, outerTopLeft.y ),        //
-					 Ogre::Vector2( innerBottomRight.x, innerTopLeft.y ),    //
-					 stateInfo.uvTopLeftBottomRight[1],                      //
-					 rgbaColour, parentDerivedTL, parentDerivedBR, invSize,  //
-					 canvasAr, invCanvasAr, this->m_derivedOrientation );
-			vertexBuffer += 6u;
-			addQuad( vertexBuffer,                                           //
-					 Ogre::Vector2( innerBottomRight.x, outerTopLeft.y ),    //
-					 Ogre::Vector2( outerBottomRight.x, innerTopLeft.y ),    //
-					 stateInfo.uvTopLeftBottomRight[2],                      //
-					 rgbaColour, parentDerivedTL, parentDerivedBR, invSize,  //
-					 canvasAr, invCanvasAr, this->m_derivedOrientation );
-			vertexBuffer += 6u;
-			// 2nd row
-			addQuad( vertexBuffer,                                           //
-					 Ogre::Vector2( outerTopLeft.x, innerTopLeft.y ),        //
-					 Ogre::Vector2( innerTopLeft.x, innerBottomRight.y ),    //
-					 stateInfo.uvTopLeftBottomRight[3],                      //
-					 rgbaColour, parentDerivedTL, parentDerivedBR, invSize,  //
-					 canvasAr, invCanvasAr, this->m_derivedOrientation );
-			vertexBuffer += 6u;
-			addQuad( vertexBuffer,                                             //
-					 Ogre::Vector2( innerTopLeft.x, innerTopLeft.y ),          //
-					 Ogre::Vector2( innerBottomRight.x, innerBottomRight.y ),  //
-					 stateInfo.uvTopLeftBottomRight[4],                        //
-					 rgbaColour, parentDerivedTL, parentDerivedBR, invSize,    //
-					 canvasAr, invCanvasAr, this->m_derivedOrientation );
-			vertexBuffer += 6u;
-			addQuad( vertexBuffer,                                             //
-					 Ogre::Vector2( innerBottomRight.x, innerTopLeft.y ),      //
-					 Ogre::Vector2( outerBottomRight.x, innerBottomRight.y ),  //
-					 stateInfo.uvTopLeftBottomRight[5],                        //
-					 rgbaColour, parentDerivedTL, parentDerivedBR, invSize,    //
-					 canvasAr, invCanvasAr, this->m_derivedOrientation );
-			vertexBuffer += 6u;
-			// 3rd row
-			addQuad( vertexBuffer,                                           //
-					 Ogre::Vector2( outerTopLeft.x, innerBottomRight.y ),    //
-					 Ogre::Vector2( innerTopLeft.x, outerBottomRight.y ),    //
-					 stateInfo.uvTopLeftBottomRight[6],                      //
-					 rgbaColour, parentDerivedTL, parentDerivedBR, invSize,  //
-					 canvasAr, invCanvasAr, this->m_derivedOrientation );
-			vertexBuffer += 6u;
-			addQuad( vertexBuffer,                                             //
-					 Ogre::Vector2( innerTopLeft.x, innerBottomRight.y ),      //
-					 Ogre::Vector2( innerBottomRight.x, outerBottomRight.y ),  //
-					 stateInfo.uvTopLeftBottomRight[7],                        //
-					 rgbaColour, parentDerivedTL, parentDerivedBR, invSize,    //
-					 canvasAr, invCanvasAr, this->m_derivedOrientation );
-			vertexBuffer += 6u;
-			addQuad( vertexBuffer,                                             //
-					 Ogre::Vector2( innerBottomRight.x, innerBottomRight.y ),  //
-					 Ogre::Vector2( outerBottomRight.x, outerBottomRight.y ),  //
-					 stateInfo.uvTopLeftBottomRight[8],                        //
-					 rgbaColour, parentDerivedTL, parentDerivedBR, invSize,    //
-					 canvasAr, invCanvasAr, this->m_derivedOrientation );
-			vertexBuffer += 6u;
+			const float gridX[4] = { outerTopLeft.x, innerTopLeft.x, innerBottomRight.x,
+									 outerBottomRight.x };
+			const float gridY[4] = { outerTopLeft.y, innerTopLeft.y, innerBottomRight.y,
+									 outerBottomRight.y };
+			if( !m_nineSlicePerCell )
+			{
+				addNineSlice( vertexBuffer, gridX, gridY, stateInfo.uvTopLeftBottomRight,
+							  rgbaColour, outerTopLeft, outerTopLeft + clipRectSize, invSize, canvasAr,
+							  invCanvasAr, getVertexOrientation() );
+				vertexBuffer += c_numNineSliceVertices;
+			}
+			else
+			{
+				// Cells have unrelated UVs. See StateInformation::sharedUvGrid
+				const Matrix2x3 vertexRot = getVertexOrientation();
+				for( size_t row = 0u; row < 3u; ++row )
+				{
+					for( size_t col = 0u; col < 3u; ++col )
+					{
+						addQuad( vertexBuffer, Ogre::Vector2( gridX[col], gridY[row] ),
+								 Ogre::Vector2( gridX[col + 1u], gridY[row + 1u] ),
+								 stateInfo.uvTopLeftBottomRight[row * 3u + col], rgbaColour,
+								 outerTopLeft, outerTopLeft + clipRectSize, invSize, canvasAr,
+								 invCanvasAr, vertexRot );
+						vertexBuffer += 6u;
+					}
+				}
+			}
 
 			*_vertexBuffer = vertexBuffer;
+
+			m_manager->_notifyVerticesRewritten( m_numVertices );
 		}
 
 		const Matrix2x3 &finalRot = this->m_derivedOrientation;
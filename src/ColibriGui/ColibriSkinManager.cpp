@@ -4,7 +4,13 @@
 
 #include "ColibriGui/ColibriProgressbar.h"
 
+#include "OgreHlmsManager.h"
+#include "OgreHlmsUnlitDatablock.h"
 #include "OgreLwString.h"
+#include "OgreRenderSystem.h"
+#include "OgreTextureBox.h"
+#include "OgreTextureGpu.h"
+#include "OgreTextureGpuManager.h"
 
 #if defined( __GNUC__ ) && !defined( __clang__ )
 #	pragma GCC diagnostic push
@@ -30,10 +36,16 @@
 namespace Colibri
 {
 	SkinManager::SkinManager( ColibriManager *colibriManager ) :
-		m_colibriManager( colibriManager )
+		m_colibriManager( colibriManager ),
+		m_packSkinTextures( false )
 	{
 	}
 	//-------------------------------------------------------------------------
+	SkinManager::~SkinManager()
+	{
+		destroyTextureArrays( m_skinTextureArrays );
+	}
+	//-------------------------------------------------------------------------
 	inline Ogre::Vector2 SkinManager::getVector2Array( const rapidjson::Value &jsonArray )
 	{
 		Ogre::Vector2 retVal( Ogre::Vector2::ZERO );
@@ -163,6 +175,40 @@ namespace Colibri
 		stateInfo.uvTopLeftBottomRight[idx].w = topLeft.y + widthHeight.y;
 	}
 	//-------------------------------------------------------------------------
+	bool SkinManager::hasSharedUvGrid( const StateInformation &stateInfo )
+	{
+		// Same grid Renderable::addNineSlice builds
+		const Ogre::Vector4 &uvTopLeft = stateInfo.uvTopLeftBottomRight[GridLocations::TopLeft];
+		const Ogre::Vector4 &uvCenter = stateInfo.uvTopLeftBottomRight[GridLocations::Center];
+		const Ogre::Vector4 &uvBottomRight =
+			stateInfo.uvTopLeftBottomRight[GridLocations::BottomRight];
+		const float u[4] = { uvTopLeft.x, uvCenter.x, uvCenter.z, uvBottomRight.z };
+		const float v[4] = { uvTopLeft.y, uvCenter.y, uvCenter.w, uvBottomRight.w };
+
+		// Cells of a border with size 0 have no area. Their UVs don't matter
+		const bool visibleCol[3] = { stateInfo.borderSize[Borders::Left] != 0.0f, true,
+									 stateInfo.borderSize[Borders::Right] != 0.0f };
+		const bool visibleRow[3] = { stateInfo.borderSize[Borders::Top] != 0.0f, true,
+									 stateInfo.borderSize[Borders::Bottom] != 0.0f };
+
+		for( size_t row = 0u; row < 3u; ++row )
+		{
+			for( size_t col = 0u; col < 3u; ++col )
+			{
+				if( !visibleRow[row] || !visibleCol[col] )
+					continue;
+
+				const Ogre::Vector4 &uv = stateInfo.uvTopLeftBottomRight[row * 3u + col];
+				if( uv.x != u[col] || uv.z != u[col + 1u] || uv.y != v[row] || uv.w != v[row + 1u] )
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+	//-------------------------------------------------------------------------
 	void SkinManager::loadSkins( const rapidjson::Value &skinsValue, const char *filename )
 	{
 		LogListener *log = m_colibriManager->getLogListener();
@@ -421,6 +467,7 @@ namespace Colibri
 				}
 				else
 				{
+					skinInfo.stateInfo.sharedUvGrid = hasSharedUvGrid( skinInfo.stateInfo );
 					m_skins[skinInfo.name] = skinInfo;
 				}
 			}
@@ -787,5 +834,228 @@ namespace Colibri
 		itTmp = d.FindMember( "default_skin_packs" );
 		if( itTmp != d.MemberEnd() && itTmp->value.IsObject() )
 			loadDefaultSkinPacks( itTmp->value, filename );
+
+		if( m_packSkinTextures )
+			packSkinTextures();
+	}
+	//-------------------------------------------------------------------------
+	void SkinManager::setPackSkinTextures( bool bPackSkinTextures )
+	{
+		m_packSkinTextures = bPackSkinTextures;
+	}
+	//-------------------------------------------------------------------------
+	struct SkinTextureToPack
+	{
+		Ogre::IdString            materialName;
+		Ogre::HlmsUnlitDatablock *datablock;
+		/// The material's texture before being packed
+		Ogre::TextureGpu         *texture;
+
+		/// Textures can only share an array if all of these match
+		bool isCompatible( const SkinTextureToPack &other ) const
+		{
+			return texture->getWidth() == other.texture->getWidth() &&
+				   texture->getHeight() == other.texture->getHeight() &&
+				   texture->getPixelFormat() == other.texture->getPixelFormat() &&
+				   texture->getNumMipmaps() == other.texture->getNumMipmaps() &&
+				   datablock->getSamplerblock( 0u ) == other.datablock->getSamplerblock( 0u );
+		}
+	};
+	//-------------------------------------------------------------------------
+	void SkinManager::destroyTextureArrays( std::vector<Ogre::TextureGpu *> &textureArrays )
+	{
+		std::vector<Ogre::TextureGpu *>::const_iterator itor = textureArrays.begin();
+		std::vector<Ogre::TextureGpu *>::const_iterator endt = textureArrays.end();
+
+		while( itor != endt )
+		{
+			Ogre::TextureGpu *textureArray = *itor;
+			textureArray->getTextureManager()->destroyTexture( textureArray );
+			++itor;
+		}
+
+		textureArrays.clear();
+	}
+	//-------------------------------------------------------------------------
+	void SkinManager::packSkinTextures()
+	{
+		LogListener *log = m_colibriManager->getLogListener();
+		char tmpBuffer[512];
+		Ogre::LwString errorMsg( Ogre::LwString::FromEmptyPointer( tmpBuffer, sizeof( tmpBuffer ) ) );
+
+		if( !m_colibriManager->getOgreRoot() )
+		{
+			log->log( "[SkinManager::packSkinTextures]: ColibriManager::setOgre must be called first",
+					  LogSeverity::Error );
+			return;
+		}
+
+		Ogre::HlmsManager *hlmsManager = m_colibriManager->getOgreHlmsManager();
+
+		// Gather the materials we can pack, and wait for their textures. Materials that
+		// are already in our arrays are gathered too, so that they get repacked together
+		// with the new ones (e.g. from a later loadSkins call)
+		std::vector<SkinTextureToPack> toPack;
+		std::set<Ogre::IdString> gatheredMaterials;
+		bool bNewMaterials = false;
+
+		SkinInfoMap::const_iterator itor = m_skins.begin();
+		SkinInfoMap::const_iterator endt = m_skins.end();
+
+		while( itor != endt )
+		{
+			const Ogre::IdString materialName = itor->second.stateInfo.materialName;
+			if( gatheredMaterials.insert( materialName ).second )
+			{
+				Ogre::HlmsDatablock *datablock = hlmsManager->getDatablockNoDefault( materialName );
+				Ogre::HlmsUnlitDatablock *unlitDatablock =
+					dynamic_cast<Ogre::HlmsUnlitDatablock *>( datablock );
+
+				Ogre::TextureGpu *texture = unlitDatablock ? unlitDatablock->getTexture( 0u ) : 0;
+
+				PackedMaterialMap::const_iterator itPacked = m_packedMaterials.find( materialName );
+				if( itPacked != m_packedMaterials.end() && texture &&
+					std::find( m_skinTextureArrays.begin(), m_skinTextureArrays.end(), texture ) !=
+						m_skinTextureArrays.end() )
+				{
+					texture = itPacked->second;
+				}
+
+				bool bCanPack = texture && texture->getTextureType() == Ogre::TextureTypes::Type2D;
+				for( uint8_t i = 1u; i < NUM_UNLIT_TEXTURE_TYPES && bCanPack; ++i )
+					bCanPack = unlitDatablock->getTexture( i ) == 0;
+
+				if( bCanPack )
+				{
+					if( itPacked == m_packedMaterials.end() || itPacked->second != texture )
+						bNewMaterials = true;
+
+					texture->waitForData();
+					SkinTextureToPack entry;
+					entry.materialName = materialName;
+					entry.datablock = unlitDatablock;
+					entry.texture = texture;
+					toPack.push_back( entry );
+				}
+			}
+
+			++itor;
+		}
+
+		if( !bNewMaterials )
+			return;  // We'd end up with the same arrays we already have
+
+		// Keep the old arrays alive until their materials have been moved to the new ones
+		std::vector<Ogre::TextureGpu *> oldTextureArrays;
+		oldTextureArrays.swap( m_skinTextureArrays );
+		m_packedMaterials.clear();
+
+		Ogre::TextureGpuManager *textureManager =
+			hlmsManager->getRenderSystem()->getTextureGpuManager();
+
+		while( !toPack.empty() )
+		{
+			// Take all the textures compatible with the first one (the same texture may
+			// be used by multiple materials; it only needs one slice)
+			std::vector<SkinTextureToPack> group;
+			std::vector<Ogre::TextureGpu *> slices;
+			{
+				const SkinTextureToPack first = toPack.front();
+				std::vector<SkinTextureToPack>::iterator itPack = toPack.begin();
+				while( itPack != toPack.end() )
+				{
+					if( first.isCompatible( *itPack ) )
+					{
+						group.push_back( *itPack );
+						if( std::find( slices.begin(), slices.end(), itPack->texture ) == slices.end() )
+							slices.push_back( itPack->texture );
+						itPack = toPack.erase( itPack );
+					}
+					else
+					{
+						++itPack;
+					}
+				}
+			}
+
+			std::vector<SkinTextureToPack>::const_iterator itGroup = group.begin();
+			std::vector<SkinTextureToPack>::const_iterator enGroup = group.end();
+
+			while( itGroup != enGroup )
+			{
+				m_packedMaterials[itGroup->materialName] = itGroup->texture;
+				++itGroup;
+			}
+
+			if( slices.size() < 2u )
+			{
+				// Nothing to gain. If they were in one of the old arrays, put them back
+				itGroup = group.begin();
+				while( itGroup != enGroup )
+				{
+					Ogre::HlmsUnlitDatablock *datablock = itGroup->datablock;
+					if( datablock->getTexture( 0u ) != itGroup->texture )
+					{
+						datablock->setTexture( 0u, itGroup->texture,
+											   datablock->getSamplerblock( 0u ) );
+					}
+					++itGroup;
+				}
+				continue;
+			}
+
+			const Ogre::TextureGpu *refTexture = slices.front();
+
+			// Names must be unique within the TextureGpuManager, which may outlive us
+			// (or be shared with other SkinManagers)
+			static uint32_t s_numTextureArraysCreated = 0u;
+
+			char tmpNameBuffer[64];
+			Ogre::LwString texName(
+				Ogre::LwString::FromEmptyPointer( tmpNameBuffer, sizeof( tmpNameBuffer ) ) );
+			texName.a( "ColibriSkinTextureArray #", s_numTextureArraysCreated++ );
+
+			Ogre::TextureGpu *textureArray = textureManager->createTexture(
+				texName.c_str(), Ogre::GpuPageOutStrategy::Discard, Ogre::TextureFlags::ManualTexture,
+				Ogre::TextureTypes::Type2DArray );
+			textureArray->setResolution( refTexture->getWidth(), refTexture->getHeight(),
+										 static_cast<uint32_t>( slices.size() ) );
+			textureArray->setPixelFormat( refTexture->getPixelFormat() );
+			textureArray->setNumMipmaps( refTexture->getNumMipmaps() );
+			textureArray->scheduleTransitionTo( Ogre::GpuResidency::Resident );
+			m_skinTextureArrays.push_back( textureArray );
+
+			const uint8_t numMipmaps = refTexture->getNumMipmaps();
+			const size_t numSlices = slices.size();
+			for( size_t i = 0u; i < numSlices; ++i )
+			{
+				for( uint8_t mip = 0u; mip < numMipmaps; ++mip )
+				{
+					Ogre::TextureBox dstBox = textureArray->getEmptyBox( mip );
+					dstBox.sliceStart = static_cast<uint32_t>( i );
+					dstBox.numSlices = 1u;
+					slices[i]->copyTo( textureArray, dstBox, mip, slices[i]->getEmptyBox( mip ), mip );
+				}
+			}
+
+			itGroup = group.begin();
+			while( itGroup != enGroup )
+			{
+				const size_t sliceIdx = static_cast<size_t>(
+					std::find( slices.begin(), slices.end(), itGroup->texture ) - slices.begin() );
+				Ogre::HlmsUnlitDatablock *datablock = itGroup->datablock;
+				datablock->setTexture( 0u, textureArray, datablock->getSamplerblock( 0u ),
+									   static_cast<uint16_t>( sliceIdx ) );
+				++itGroup;
+			}
+
+			errorMsg.clear();
+			errorMsg.a( "[SkinManager::packSkinTextures]: Packed ", (uint32_t)numSlices,
+						" textures used by ", (uint32_t)group.size(), " materials into ",
+						texName.c_str() );
+			log->log( errorMsg.c_str(), LogSeverity::Info );
+		}
+
+		destroyTextureArrays( oldTextureArrays );
 	}
 }
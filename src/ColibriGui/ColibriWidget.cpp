@@ -8,6 +8,11 @@
 
 namespace Colibri
 {
+	/// Values of Widget::m_overlapFreeState
+	static const uint8_t c_overlapFreeUnknown = 0u;
+	static const uint8_t c_overlapFreeYes = 1u;
+	static const uint8_t c_overlapFreeNo = 2u;
+
 	static Borders::Borders c_reciprocateBorders[Borders::NumBorders+1u] =
 	{
 		Borders::Bottom,
@@ -19,6 +24,41 @@ namespace Colibri
 
 	const Matrix2x3 Matrix2x3::IDENTITY( 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f );
 
+	/// Upper limit of cells per axis of Widget::HitTestGrid
+	static const uint32_t c_maxHitTestGridCells = 256u;
+
+	struct Widget::HitTestGrid
+	{
+		/// Top left corner of the grid, in the local space of our children
+		Ogre::Vector2 origin;
+		Ogre::Vector2 invCellSize;
+		/// Cells are expanded by this much when placing children in them, so that
+		/// rounding errors when converting the cursor to local space don't miss them.
+		Ogre::Vector2 margin;
+		uint32_t numCellsX;
+		uint32_t numCellsY;
+		/// Children in cell i are childIndices[cellStart[i]; cellStart[i+1]), in the
+		/// same order as in m_children (i.e. sorted by z-order)
+		std::vector<uint32_t> cellStart;
+		std::vector<uint32_t> childIndices;
+		bool dirty;
+
+		HitTestGrid() : numCellsX( 0u ), numCellsY( 0u ), dirty( true ) {}
+
+		uint32_t getCellX( float x ) const
+		{
+			const float cell = std::floor( ( x - origin.x ) * invCellSize.x );
+			return static_cast<uint32_t>(
+				Ogre::Math::Clamp( cell, 0.0f, static_cast<float>( numCellsX - 1u ) ) );
+		}
+		uint32_t getCellY( float y ) const
+		{
+			const float cell = std::floor( ( y - origin.y ) * invCellSize.y );
+			return static_cast<uint32_t>(
+				Ogre::Math::Clamp( cell, 0.0f, static_cast<float>( numCellsY - 1u ) ) );
+		}
+	};
+
 	Widget::Widget( ColibriManager *manager ) :
 		m_parent( 0 ),
 		m_numNonRenderables( 0 ),
@@ -33,7 +73,12 @@ namespace Colibri
 		m_mouseReleaseTriggersPrimaryAction( true ),
 		m_consumesScroll( false ),
 		m_culled( false ),
+		m_derivedTransformStale( false ),
+		m_derivedTransformCheckedEpoch( 0u ),
+		m_overlapFreeState( c_overlapFreeUnknown ),
+		m_hitTestGrid( 0 ),
 		m_breadthFirst( false ),
+		m_reorderDraws( false ),
 		m_userId( 0 ),
 		m_currentState( States::Idle ),
 		m_position( Ogre::Vector2::ZERO ),
@@ -43,6 +88,7 @@ namespace Colibri
 		m_derivedTopLeft( Ogre::Vector2::ZERO ),
 		m_derivedBottomRight( Ogre::Vector2::ZERO ),
 		m_derivedOrientation( Matrix2x3::IDENTITY ),
+		m_derivedScrollOffset( Ogre::Vector2::ZERO ),
 		m_clipBorderTL( Ogre::Vector2::ZERO ),
 		m_clipBorderBR( Ogre::Vector2::ZERO ),
 		m_accumMinClipTL( -1.0f ),
@@ -64,6 +110,8 @@ namespace Colibri
 	Widget::~Widget()
 	{
 		COLIBRI_ASSERT( m_children.empty() && "_destroy not called before deleting!" );
+		delete m_hitTestGrid;
+		m_hitTestGrid = 0;
 	}
 	//-------------------------------------------------------------------------
 	size_t Widget::notifyParentChildIsDestroyed( Widget *childWidgetBeingRemoved )
@@ -81,6 +129,8 @@ namespace Colibri
 			//It may not be found if we're also in destruction phase
 			retVal = static_cast<size_t>( itor - m_children.begin() );
 			m_children.erase( itor );
+			invalidateOverlapFreeState();
+			invalidateHitTestGrid();
 
 			COLIBRI_ASSERT( (retVal < m_numWidgets && !childWidgetBeingRemoved->isWindow()) ||
 							(retVal >= m_numWidgets && childWidgetBeingRemoved->isWindow()) );
@@ -184,6 +234,7 @@ namespace Colibri
 #endif
 
 		setWidgetNavigationDirty();
+		setDerivedTransformStale( false );
 
 		for( size_t i=0; i<Borders::NumBorders; ++i )
 		{
@@ -246,6 +297,11 @@ namespace Colibri
 		COLIBRI_ASSERT( (parent->isWindow() || thisIsWindow == parent->isWindow()) &&
 						"Regular Widgets cannot be parents of windows!" );
 		this->m_parent = parent;
+		m_manager->_notifyDrawListDirty();
+		m_manager->_notifyDirtyRegionFull();
+		m_manager->_invalidateDerivedTransformChecks();
+		parent->invalidateOverlapFreeState();
+		parent->invalidateHitTestGrid();
 		if( !thisIsWindow )
 		{
 			size_t idx = parent->m_numWidgets;
@@ -296,6 +352,12 @@ namespace Colibri
 		{
 			m_hidden = hidden;
 
+			// Our children are clipped to our rect, except child windows
+			if( isRenderable() && !isWindow() )
+				m_manager->_notifyDirtyRegion( static_cast<Renderable *>( this ) );
+			else
+				m_manager->_notifyDirtyRegionFull();
+
 			if( m_currentState != States::Idle && m_currentState != States::Disabled )
 			{
 				setState( States::Idle );
@@ -410,6 +472,289 @@ namespace Colibri
 		return r;
 	}
 	//-------------------------------------------------------------------------
+	void Widget::invalidateOverlapFreeState()
+	{
+		// We can't stop at the first unknown ancestor: _isSubtreeOverlapFree stops evaluating
+		// children as soon as one fails, thus an unknown widget may have known parents.
+		Widget *widget = this;
+		while( widget )
+		{
+			widget->m_overlapFreeState = c_overlapFreeUnknown;
+			widget = widget->m_parent;
+		}
+
+		// Which widgets get rendered in breadth first may change
+		if( m_manager->getAutoBreadthFirst() )
+			m_manager->_notifyDrawListDirty();
+	}
+	//-------------------------------------------------------------------------
+	void Widget::invalidateHitTestGrid()
+	{
+		if( m_hitTestGrid )
+			m_hitTestGrid->dirty = true;
+	}
+	//-------------------------------------------------------------------------
+	void Widget::setHitTestGridEnabled( bool bEnabled )
+	{
+		if( bEnabled && !m_hitTestGrid )
+		{
+			m_hitTestGrid = new HitTestGrid();
+		}
+		else if( !bEnabled && m_hitTestGrid )
+		{
+			delete m_hitTestGrid;
+			m_hitTestGrid = 0;
+		}
+	}
+	//-------------------------------------------------------------------------
+	void Widget::rebuildHitTestGrid()
+	{
+		HitTestGrid &grid = *m_hitTestGrid;
+
+		grid.dirty = false;
+		grid.cellStart.clear();
+		grid.childIndices.clear();
+
+		const size_t numWidgets = m_numWidgets;
+		if( numWidgets == 0u )
+		{
+			grid.numCellsX = 0u;
+			grid.numCellsY = 0u;
+			return;
+		}
+
+		Ogre::Vector2 minTopLeft( std::numeric_limits<float>::max() );
+		Ogre::Vector2 maxBottomRight( -std::numeric_limits<float>::max() );
+
+		for( size_t i = 0u; i < numWidgets; ++i )
+		{
+			const Widget *child = m_children[i];
+			minTopLeft.makeFloor( child->m_position );
+			minTopLeft.makeFloor( child->m_position + child->m_size );
+			maxBottomRight.makeCeil( child->m_position );
+			maxBottomRight.makeCeil( child->m_position + child->m_size );
+		}
+
+		// Aim for roughly one child per cell, with cells as square as possible
+		// (e.g. a vertical list gets a single column)
+		const Ogre::Vector2 extent = maxBottomRight - minTopLeft;
+		const float fNumWidgets = static_cast<float>( numWidgets );
+		const float maxCells = static_cast<float>( c_maxHitTestGridCells );
+
+		float numCellsX = 1.0f;
+		if( extent.y > 0.0f )
+			numCellsX = std::floor( std::sqrt( fNumWidgets * extent.x / extent.y ) + 0.5f );
+		else if( extent.x > 0.0f )
+			numCellsX = fNumWidgets;
+		numCellsX = Ogre::Math::Clamp( numCellsX, 1.0f, maxCells );
+		const float numCellsY = Ogre::Math::Clamp( std::ceil( fNumWidgets / numCellsX ), 1.0f,
+												   extent.y > 0.0f ? maxCells : 1.0f );
+
+		grid.numCellsX = static_cast<uint32_t>( numCellsX );
+		grid.numCellsY = static_cast<uint32_t>( numCellsY );
+		grid.origin = minTopLeft;
+		grid.invCellSize.x = extent.x > 0.0f ? ( numCellsX / extent.x ) : 0.0f;
+		grid.invCellSize.y = extent.y > 0.0f ? ( numCellsY / extent.y ) : 0.0f;
+		grid.margin.x = extent.x / numCellsX * 0.01f;
+		grid.margin.y = extent.y / numCellsY * 0.01f;
+
+		// Count how many children touch each cell, then fill them. Children are
+		// visited in order, so each cell ends up sorted by z-order.
+		const size_t numCells = grid.numCellsX * grid.numCellsY;
+		grid.cellStart.resize( numCells + 1u, 0u );
+
+		for( int pass = 0; pass < 2; ++pass )
+		{
+			for( size_t i = 0u; i < numWidgets; ++i )
+			{
+				const Widget *child = m_children[i];
+				Ogre::Vector2 topLeft( child->m_position );
+				Ogre::Vector2 bottomRight( child->m_position + child->m_size );
+				topLeft.makeFloor( child->m_position + child->m_size );
+				bottomRight.makeCeil( child->m_position );
+
+				const uint32_t minX = grid.getCellX( topLeft.x - grid.margin.x );
+				const uint32_t minY = grid.getCellY( topLeft.y - grid.margin.y );
+				const uint32_t maxX = grid.getCellX( bottomRight.x + grid.margin.x );
+				const uint32_t maxY = grid.getCellY( bottomRight.y + grid.margin.y );
+
+				for( uint32_t y = minY; y <= maxY; ++y )
+				{
+					for( uint32_t x = minX; x <= maxX; ++x )
+					{
+						const size_t cellIdx = y * grid.numCellsX + x;
+						if( pass == 0 )
+							++grid.cellStart[cellIdx + 1u];
+						else
+							grid.childIndices[grid.cellStart[cellIdx]++] = static_cast<uint32_t>( i );
+					}
+				}
+			}
+
+			if( pass == 0 )
+			{
+				for( size_t i = 0u; i < numCells; ++i )
+					grid.cellStart[i + 1u] += grid.cellStart[i];
+				grid.childIndices.resize( grid.cellStart[numCells] );
+			}
+			else
+			{
+				// The fill advanced each cellStart[i] to where cell i+1 begins. Undo that.
+				for( size_t i = numCells; i > 0u; --i )
+					grid.cellStart[i] = grid.cellStart[i - 1u];
+				grid.cellStart[0] = 0u;
+			}
+		}
+	}
+	//-------------------------------------------------------------------------
+	static bool compareLeftEdge( const Widget *a, const Widget *b )
+	{
+		return a->getLocalTopLeft().x < b->getLocalTopLeft().x;
+	}
+	//-------------------------------------------------------------------------
+	bool Widget::_isSubtreeOverlapFree()
+	{
+		if( m_overlapFreeState != c_overlapFreeUnknown )
+			return m_overlapFreeState == c_overlapFreeYes;
+
+		bool bOverlapFree = true;
+		bool bHasUnboundedChild = false;
+
+		for( Widget *child : m_children )
+		{
+			const Ogre::Vector4 &rot = child->m_orientation;
+			if( rot.x != 1.0f || rot.y != 0.0f || rot.z != 0.0f || rot.w != 1.0f ||
+				!child->_isSubtreeOverlapFree() )
+			{
+				bOverlapFree = false;
+				break;
+			}
+
+			bHasUnboundedChild |= child->getWidgetRenderType() != WidgetRenderType::Normal ||
+								  child->isLabelBmp();
+		}
+
+		if( bOverlapFree && bHasUnboundedChild && m_children.size() > 1u )
+			bOverlapFree = false;
+
+		if( bOverlapFree && m_children.size() > 1u )
+		{
+			// Sweep from left to right. Only widgets that start before
+			// the current one ends can overlap with it.
+			WidgetVec &sorted = m_manager->m_overlapTestScratch;
+			sorted = m_children;
+			std::sort( sorted.begin(), sorted.end(), compareLeftEdge );
+
+			const size_t numChildren = sorted.size();
+			for( size_t i = 0u; i < numChildren && bOverlapFree; ++i )
+			{
+				const Ogre::Vector2 aTL = sorted[i]->getLocalTopLeft();
+				const Ogre::Vector2 aBR = sorted[i]->getLocalBottomRight();
+
+				for( size_t j = i + 1u; j < numChildren && bOverlapFree; ++j )
+				{
+					const Ogre::Vector2 bTL = sorted[j]->getLocalTopLeft();
+					if( bTL.x >= aBR.x )
+						break;
+
+					const Ogre::Vector2 bBR = sorted[j]->getLocalBottomRight();
+					if( aTL.y < bBR.y && bTL.y < aBR.y )
+						bOverlapFree = false;
+				}
+			}
+		}
+
+		m_overlapFreeState = bOverlapFree ? c_overlapFreeYes : c_overlapFreeNo;
+		return bOverlapFree;
+	}
+	//-------------------------------------------------------------------------
+	void Widget::setCulled( bool bCulled )
+	{
+		if( m_culled != bCulled )
+		{
+			m_culled = bCulled;
+			m_manager->_notifyDrawListDirty();
+		}
+	}
+	//-------------------------------------------------------------------------
+	bool Widget::setCulledAndUpdateDerivedTransform( bool bCulled, const Ogre::Vector2 &parentPos,
+													 const Matrix2x3 &parentRot )
+	{
+		setCulled( bCulled );
+		if( bCulled )
+		{
+			// Nothing we (or our children) draw depends on it. Don't waste time on it
+			setDerivedTransformStale( true );
+		}
+		else
+		{
+			updateDerivedTransform( parentPos, parentRot );
+			setDerivedTransformStale( false );
+		}
+		return bCulled;
+	}
+	//-------------------------------------------------------------------------
+	void Widget::setDerivedTransformStale( bool bStale )
+	{
+		if( m_derivedTransformStale != bStale )
+		{
+			m_derivedTransformStale = bStale;
+			m_manager->_notifyDerivedTransformStale( bStale );
+		}
+	}
+	//-------------------------------------------------------------------------
+	void Widget::_updateDerivedTransformIfVisible( const Ogre::Vector2 &parentPos,
+												   const Matrix2x3 &parentRot )
+	{
+		if( m_hidden || m_culled )
+			setDerivedTransformStale( true );
+		else
+			_updateDerivedTransformOnly( parentPos, parentRot );
+	}
+	//-------------------------------------------------------------------------
+	void Widget::updateStaleDerivedTransform() const
+	{
+		// Nothing became stale since we last checked. Avoids walking all our
+		// parents every time when some unrelated widget is culled.
+		if( m_derivedTransformCheckedEpoch == m_manager->_getStaleDerivedTransformEpoch() )
+			return;
+
+		// Update the outermost stale subtree we belong to. Its children that are
+		// hidden or culled become stale subtrees of their own, so repeat until
+		// the path from the window to us is up to date.
+		while( true )
+		{
+			Widget *staleRoot = 0;
+			for( Widget *widget = const_cast<Widget *>( this ); widget; widget = widget->m_parent )
+			{
+				if( widget->m_derivedTransformStale )
+					staleRoot = widget;
+			}
+
+			if( !staleRoot )
+			{
+				// Updating stale subtrees may have made some of their children stale, but not
+				// the ones in our path. Thus the current epoch is the right one to store.
+				m_derivedTransformCheckedEpoch = m_manager->_getStaleDerivedTransformEpoch();
+				return;
+			}
+
+			const Widget *parent = staleRoot->m_parent;
+			if( parent )
+			{
+				const Ogre::Vector2 parentPos =
+					parent->m_derivedTopLeft + ( parent->m_clipBorderTL - parent->getCurrentScroll() ) *
+												   m_manager->getInvCanvasSize2x();
+				staleRoot->_updateDerivedTransformOnly( parentPos, parent->m_derivedOrientation );
+			}
+			else
+			{
+				staleRoot->_updateDerivedTransformOnly( -Ogre::Vector2::UNIT_SCALE,
+														Matrix2x3::IDENTITY );
+			}
+		}
+	}
+	//-------------------------------------------------------------------------
 	void Widget::updateDerivedTransform( const Ogre::Vector2 &parentPos, const Matrix2x3 &parentRot )
 	{
 		const float invCanvasAr = m_manager->getCanvasInvAspectRatio();
@@ -433,6 +778,23 @@ namespace Colibri
 
 		m_derivedOrientation = mul( parentRot, m_derivedOrientation );
 
+		if( m_parent )
+		{
+			// Our parent's scroll shifts all of its children in the space of parentRot.
+			// Rotations of our own (or of our children) don't matter because they're
+			// performed around centers that get shifted too.
+			const Ogre::Vector2 scroll = -m_parent->getCurrentScroll() * invCanvasSize2x;
+			m_derivedScrollOffset.x = parentRot.m[0][0] * scroll.x +  //
+									  parentRot.m[0][1] * scroll.y * invCanvasAr;
+			m_derivedScrollOffset.y = parentRot.m[1][0] * scroll.x +  //
+									  parentRot.m[1][1] * scroll.y * invCanvasAr;
+			m_derivedScrollOffset += m_parent->m_derivedScrollOffset;
+		}
+		else
+		{
+			m_derivedScrollOffset = Ogre::Vector2::ZERO;
+		}
+
 #if COLIBRIGUI_DEBUG >= COLIBRIGUI_DEBUG_MEDIUM
 		m_transformOutOfDate = false;
 #endif
@@ -656,6 +1018,8 @@ namespace Colibri
 	//-------------------------------------------------------------------------
 	bool Widget::intersects( const Ogre::Vector2 &posNdc ) const
 	{
+		if( m_manager->_hasStaleDerivedTransforms() )
+			updateStaleDerivedTransform();
 		COLIBRI_ASSERT_MEDIUM( !m_transformOutOfDate );
 		TODO_account_rotation;
 		return !( posNdc.x < m_derivedTopLeft.x ||
@@ -664,6 +1028,32 @@ namespace Colibri
 				  posNdc.y > m_derivedBottomRight.y );
 	}
 	//-------------------------------------------------------------------------
+	FocusPair Widget::hitTestChild( Widget *widget, const Ogre::Vector2 &newPosNdc,
+									const Ogre::Vector2 &currentScroll )
+	{
+		FocusPair retVal;
+
+		if( ( widget->m_clickable || widget->m_childrenClickable ) &&  //
+			!widget->isDisabled() &&                                   //
+			!widget->isHidden() &&                                     //
+			this->intersectsChild( widget, currentScroll ) &&          //
+			widget->intersects( newPosNdc ) )
+		{
+			if( widget->m_clickable )
+				retVal.widget = widget;
+
+			if( widget->m_childrenClickable )
+			{
+				FocusPair childFocusPair;
+				childFocusPair = widget->_setIdleCursorMoved( newPosNdc );
+				if( childFocusPair.widget )
+					retVal = childFocusPair;
+			}
+		}
+
+		return retVal;
+	}
+	//-------------------------------------------------------------------------
 	FocusPair Widget::_setIdleCursorMoved( const Ogre::Vector2 &newPosNdc )
 	{
 		FocusPair retVal;
@@ -693,30 +1083,44 @@ namespace Colibri
 
 		Ogre::Vector2 currentScroll = getCurrentScroll();
 
-		WidgetVec::const_iterator itor = m_children.begin();
-		WidgetVec::const_iterator endt = m_children.begin() + ptrdiff_t( m_numWidgets );
-
-		while( itor != endt )
+		if( m_hitTestGrid )
 		{
-			Widget *widget = *itor;
-			if( ( widget->m_clickable || widget->m_childrenClickable ) &&  //
-				!widget->isDisabled() &&                                   //
-				!widget->isHidden() &&                                     //
-				this->intersectsChild( widget, currentScroll ) &&          //
-				widget->intersects( newPosNdc ) )
-			{
-				if( widget->m_clickable )
-					retVal.widget = widget;
+			if( m_hitTestGrid->dirty )
+				rebuildHitTestGrid();
 
-				if( widget->m_childrenClickable )
+			const HitTestGrid &grid = *m_hitTestGrid;
+			if( grid.numCellsX > 0u )
+			{
+				// Bring the cursor to the local space of our children
+				const Ogre::Vector2 invCanvasSize2x = m_manager->getInvCanvasSize2x();
+				const Ogre::Vector2 localPos = ( newPosNdc - m_derivedTopLeft ) / invCanvasSize2x -
+											   m_clipBorderTL + currentScroll;
+				const size_t cellIdx =
+					grid.getCellY( localPos.y ) * grid.numCellsX + grid.getCellX( localPos.x );
+
+				// Children later in the list are on top, thus the last hit wins.
+				// Going backwards, we can stop at the first one.
+				const uint32_t *cellBegin = grid.childIndices.data() + grid.cellStart[cellIdx];
+				const uint32_t *cellEnd = grid.childIndices.data() + grid.cellStart[cellIdx + 1u];
+				while( cellEnd != cellBegin && !retVal.widget )
 				{
-					FocusPair childFocusPair;
-					childFocusPair = widget->_setIdleCursorMoved( newPosNdc );
-					if( childFocusPair.widget )
-						retVal = childFocusPair;
+					--cellEnd;
+					retVal = hitTestChild( m_children[*cellEnd], newPosNdc, currentScroll );
 				}
 			}
-			++itor;
+		}
+		else
+		{
+			WidgetVec::const_iterator itor = m_children.begin();
+			WidgetVec::const_iterator endt = m_children.begin() + ptrdiff_t( m_numWidgets );
+
+			while( itor != endt )
+			{
+				const FocusPair childFocusPair = hitTestChild( *itor, newPosNdc, currentScroll );
+				if( childFocusPair.widget )
+					retVal = childFocusPair;
+				++itor;
+			}
 		}
 
 		retVal.window = getFirstParentWindow();
@@ -730,20 +1134,13 @@ namespace Colibri
 	//-------------------------------------------------------------------------
 	void Widget::broadcastNewVao( Ogre::VertexArrayObject *vao, Ogre::VertexArrayObject *textVao )
 	{
-		WidgetVec::const_iterator itor = m_children.begin();
-		WidgetVec::const_iterator end  = m_children.end();
-
-		while( itor != end )
-		{
-			(*itor)->broadcastNewVao( vao, textVao );
-			++itor;
-		}
 	}
 	//-------------------------------------------------------------------------
 	void Widget::_updateDerivedTransformOnly( const Ogre::Vector2 &parentPos,
 											  const Matrix2x3 &parentRot )
 	{
 		updateDerivedTransform( parentPos, parentRot );
+		setDerivedTransformStale( false );
 
 		const Ogre::Vector2 invCanvasSize2x	= m_manager->getInvCanvasSize2x();
 		const Ogre::Vector2 outerTopLeft	= this->m_derivedTopLeft;
@@ -755,7 +1152,20 @@ namespace Colibri
 
 		while( itor != end )
 		{
-			(*itor)->_updateDerivedTransformOnly( outerTopLeftWithClipping, finalRot );
+			(*itor)->_updateDerivedTransformIfVisible( outerTopLeftWithClipping, finalRot );
+			++itor;
+		}
+	}
+	//-------------------------------------------------------------------------
+	void Widget::_getVertexCountUpperBound( size_t &inOutNumVertices,
+											size_t &inOutNumTextVertices ) const
+	{
+		WidgetVec::const_iterator itor = m_children.begin();
+		WidgetVec::const_iterator end  = m_children.end();
+
+		while( itor != end )
+		{
+			(*itor)->_getVertexCountUpperBound( inOutNumVertices, inOutNumTextVertices );
 			++itor;
 		}
 	}
@@ -766,15 +1176,10 @@ namespace Colibri
 										  const Ogre::Vector2 &parentCurrentScrollPos,
 										  const Matrix2x3 &parentRot )
 	{
-		updateDerivedTransform( parentPos, parentRot );
-
-		m_culled = true;
-
-		if( !m_parent->intersectsChild( this, parentCurrentScrollPos ) || m_hidden )
+		const bool bCulled = !m_parent->intersectsChild( this, parentCurrentScrollPos ) || m_hidden;
+		if( setCulledAndUpdateDerivedTransform( bCulled, parentPos, parentRot ) )
 			return;
 
-		m_culled = false;
-
 		Ogre::Vector2 invCanvasSize2x = m_manager->getInvCanvasSize2x();
 
 		Ogre::Vector2 parentDerivedTL = m_parent->m_derivedTopLeft +
@@ -816,7 +1221,20 @@ namespace Colibri
 	//-------------------------------------------------------------------------
 	void Widget::addChildrenCommands( ApiEncapsulatedObjects &apiObject, bool collectingBreadthFirst )
 	{
-		if( !m_breadthFirst && !collectingBreadthFirst )
+		bool bBreadthFirst = m_breadthFirst;
+		if( !bBreadthFirst && !collectingBreadthFirst && !m_reorderDraws &&
+			m_children.size() > 1u && m_manager->getAutoBreadthFirst() && _isSubtreeOverlapFree() )
+		{
+			// Breadth first is guaranteed to look the same. Take advantage of it.
+			bBreadthFirst = true;
+			m_manager->_notifyAutoBreadthFirstUsed();
+		}
+
+		if( m_reorderDraws && !bBreadthFirst && !collectingBreadthFirst )
+		{
+			m_manager->_addReorderedChildrenCommands( this, apiObject );
+		}
+		else if( !bBreadthFirst && !collectingBreadthFirst )
 		{
 			WidgetVec::const_iterator itor = m_children.begin();
 			WidgetVec::const_iterator endt = m_children.begin() + ptrdiff_t( m_numNonRenderables );
@@ -994,6 +1412,14 @@ namespace Colibri
 #if COLIBRIGUI_DEBUG >= COLIBRIGUI_DEBUG_MEDIUM
 		m_transformOutOfDate = true;
 #endif
+		// Our children moving along with us doesn't change how they overlap each other
+		if( !( dirtyReason & TransformDirtyParentCaller ) )
+		{
+			invalidateOverlapFreeState();
+			if( m_parent )
+				m_parent->invalidateHitTestGrid();
+		}
+
 		WidgetVec::const_iterator itor = m_children.begin();
 		WidgetVec::const_iterator end  = m_children.end();
 
@@ -1101,6 +1527,8 @@ namespace Colibri
 	//-------------------------------------------------------------------------
 	void Widget::updateZOrderDirty()
 	{
+		if( getZOrderDirty() )
+			invalidateHitTestGrid();
 		reorderWidgetVec( getZOrderDirty(), m_children );
 		m_zOrderDirty = false;
 		m_zOrderHasDirtyChildren = false;
@@ -1262,24 +1690,32 @@ namespace Colibri
 	//-------------------------------------------------------------------------
 	const Ogre::Vector2& Widget::getDerivedTopLeft() const
 	{
+		if( m_manager->_hasStaleDerivedTransforms() )
+			updateStaleDerivedTransform();
 		COLIBRI_ASSERT_MEDIUM( !m_transformOutOfDate );
 		return m_derivedTopLeft;
 	}
 	//-------------------------------------------------------------------------
 	const Ogre::Vector2& Widget::getDerivedBottomRight() const
 	{
+		if( m_manager->_hasStaleDerivedTransforms() )
+			updateStaleDerivedTransform();
 		COLIBRI_ASSERT_MEDIUM( !m_transformOutOfDate );
 		return m_derivedBottomRight;
 	}
 	//-------------------------------------------------------------------------
 	const Matrix2x3 &Widget::getDerivedOrientation() const
 	{
+		if( m_manager->_hasStaleDerivedTransforms() )
+			updateStaleDerivedTransform();
 		COLIBRI_ASSERT_MEDIUM( !m_transformOutOfDate );
 		return m_derivedOrientation;
 	}
 	//-------------------------------------------------------------------------
 	Ogre::Vector2 Widget::getDerivedCenter() const
 	{
+		if( m_manager->_hasStaleDerivedTransforms() )
+			updateStaleDerivedTransform();
 		COLIBRI_ASSERT_MEDIUM( !m_transformOutOfDate );
 		return (m_derivedTopLeft + m_derivedBottomRight) * 0.5f;
 	}
@@ -336,6 +336,7 @@ namespace Colibri
 		const Ogre::Vector2 pixelSize = m_manager->getPixelSize();
 
 		const Ogre::Vector2 maxScroll = getMaxScroll();
+		const Ogre::Vector2 prevScroll = m_currentScroll;
 
 		if( m_nextScroll.y < 0.0f )
 		{
@@ -371,6 +372,15 @@ namespace Colibri
 			m_currentScroll = m_nextScroll;
 		}
 
+		if( m_currentScroll != prevScroll )
+		{
+			// Our widgets are clipped to our rect, but our child windows aren't
+			if( m_childWindows.empty() )
+				m_manager->_notifyDirtyRegion( this );
+			else
+				m_manager->_notifyDirtyRegionFull();
+		}
+
 		for( size_t i = 0u; i < Borders::NumBorders; ++i )
 			evaluateScrollArrowVisibility( static_cast<Borders::Borders>( i ) );
 
@@ -563,6 +573,7 @@ namespace Colibri
 											  const Matrix2x3 &parentRot )
 	{
 		updateDerivedTransform( parentPos, parentRot );
+		setDerivedTransformStale( false );
 
 		const Ogre::Vector2 invCanvasSize2x = m_manager->getInvCanvasSize2x();
 		const Ogre::Vector2 outerTopLeft = this->m_derivedTopLeft;
@@ -575,7 +586,7 @@ namespace Colibri
 
 		while( itor != end )
 		{
-			( *itor )->_updateDerivedTransformOnly( outerTopLeftWithClipping, finalRot );
+			( *itor )->_updateDerivedTransformIfVisible( outerTopLeftWithClipping, finalRot );
 			++itor;
 		}
 	}
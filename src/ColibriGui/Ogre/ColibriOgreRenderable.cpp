@@ -1,13 +1,28 @@
 
 #include "ColibriGui/Ogre/ColibriOgreRenderable.h"
 #include "ColibriGui/ColibriManager.h"
+#include "ColibriGui/ColibriRenderable.h"
 
 #include "OgreSceneManager.h"
+#include "Vao/OgreIndexBufferPacked.h"
 #include "Vao/OgreVaoManager.h"
 #include "Vao/OgreVertexArrayObject.h"
 
 namespace Ogre
 {
+	// Must match Colibri::UiVertex & Colibri::GlyphVertex.
+	// Shaders still declare these attributes as floats; the GPU converts them.
+#if COLIBRI_COMPACT_VERTICES > 1
+	static const VertexElementType c_positionVertexElementType = VET_HALF2;
+#else
+	static const VertexElementType c_positionVertexElementType = VET_FLOAT2;
+#endif
+#if COLIBRI_COMPACT_VERTICES
+	static const VertexElementType c_clipVertexElementType = VET_HALF4;
+#else
+	static const VertexElementType c_clipVertexElementType = VET_FLOAT4;
+#endif
+
 	ColibriOgreRenderable::ColibriOgreRenderable( IdType id, ObjectMemoryManager *objectMemoryManager,
 												  SceneManager *manager, uint8 renderQueueId,
 												  Colibri::ColibriManager *colibriManager ) :
@@ -35,7 +50,7 @@ namespace Ogre
 		//that belong to this MovableObject.
 		mRenderables.push_back( this );
 
-		setVao( colibriManager->getVao() );
+		setVao( colibriManager->_getVertexFormatVao() );
 
 		//If we don't set a datablock, we'll crash Ogre.
 //		this->setDatablock( Root::getSingleton().getHlmsManager()->
@@ -53,11 +68,11 @@ namespace Ogre
 	{
 	}
 	//-----------------------------------------------------------------------------------
-	/*Ogre::IndexBufferPacked* ColibriOgreRenderable::createIndexBuffer( VaoManager *vaoManager )
+	IndexBufferPacked *ColibriOgreRenderable::createIndexBuffer( VaoManager *vaoManager )
 	{
-		//6 indices per quad (3 indices per triangle)
-		//3x3 grid = 9 quads => 6 x 9 indices per widget.
-		//Vertices are expected to be layed out like this:
+		// 6 indices per quad (3 indices per triangle)
+		// 3x3 grid = 9 quads => 6 x 9 indices per widget.
+		// Vertices are expected to be layed out like this:
 		//	 0, 1,		 2, 3,
 		//	 4, 5,		 6, 7,
 		//
@@ -74,46 +89,32 @@ namespace Ogre
 		//	x-x------x-x
 		//	| |		 | |
 		//	x-x------x-x
-		// maxVerticesPerBuffer = 4096; which means we support up to 4096 widgets per Window.
+		// c_maxNineSlicesPerDraw = 4096; which means a single draw supports up to 4096 widgets.
 		// And this precomputed buffer requires 432kb
-		const size_t verticesPerQuad		= 16u;
-		const size_t maxVerticesPerBuffer	= 65536u / verticesPerQuad;
-		const size_t numIndices = maxVerticesPerBuffer * 6u * 9u;
-		uint16 *indices = reinterpret_cast<uint16*>( OGRE_MALLOC_SIMD( sizeof(uint16) * numIndices,
-																	   MEMCATEGORY_GEOMETRY ) );
-		for( size_t i=0; i<numIndices; i += (6u * 9u) )
+		using namespace Colibri;
+		const size_t numIndices = c_maxNineSlicesPerDraw * c_numNineSliceIndices;
+		uint16 *indices = reinterpret_cast<uint16 *>(
+			OGRE_MALLOC_SIMD( sizeof( uint16 ) * numIndices, MEMCATEGORY_GEOMETRY ) );
+		for( size_t i = 0u; i < c_maxNineSlicesPerDraw; ++i )
 		{
-			//Perform top, then center, then bottom rows
-			for( size_t j=0; j<3u; ++j )
+			// Perform top, then center, then bottom rows
+			for( size_t j = 0u; j < 3u; ++j )
 			{
-				const size_t dstIdx = i + j * 18u;
-				const size_t srcIdx = i + j * 4u;
-				//Left column's quad
-				indices[dstIdx +  0u] = srcIdx + 0u;
-				indices[dstIdx +  1u] = srcIdx + 4u;
-				indices[dstIdx +  2u] = srcIdx + 5u;
-
-				indices[dstIdx +  3u] = srcIdx + 5u;
-				indices[dstIdx +  4u] = srcIdx + 1u;
-				indices[dstIdx +  5u] = srcIdx + 0u;
-
-				//Center column's quad
-				indices[dstIdx +  6u] = srcIdx + 1u;
-				indices[dstIdx +  7u] = srcIdx + 5u;
-				indices[dstIdx +  8u] = srcIdx + 6u;
-
-				indices[dstIdx +  9u] = srcIdx + 6u;
-				indices[dstIdx + 10u] = srcIdx + 2u;
-				indices[dstIdx + 11u] = srcIdx + 1u;
-
-				//Right column's quad
-				indices[dstIdx + 12u] = srcIdx + 2u;
-				indices[dstIdx + 13u] = srcIdx + 6u;
-				indices[dstIdx + 14u] = srcIdx + 7u;
-
-				indices[dstIdx + 15u] = srcIdx + 7u;
-				indices[dstIdx + 16u] = srcIdx + 3u;
-				indices[dstIdx + 17u] = srcIdx + 2u;
+				const size_t dstIdx = i * c_numNineSliceIndices + j * 18u;
+				const uint16 srcIdx = static_cast<uint16>( i * c_numNineSliceVertices + j * 4u );
+				// Same order as Renderable::addQuad: TL, BL, BR, BR, TR, TL
+				for( uint16 k = 0u; k < 3u; ++k )
+				{
+					// Left, center & right column's quads
+					const uint16 topLeft = static_cast<uint16>( srcIdx + k );
+					indices[dstIdx + k * 6u + 0u] = topLeft;
+					indices[dstIdx + k * 6u + 1u] = static_cast<uint16>( topLeft + 4u );
+					indices[dstIdx + k * 6u + 2u] = static_cast<uint16>( topLeft + 5u );
+
+					indices[dstIdx + k * 6u + 3u] = static_cast<uint16>( topLeft + 5u );
+					indices[dstIdx + k * 6u + 4u] = static_cast<uint16>( topLeft + 1u );
+					indices[dstIdx + k * 6u + 5u] = topLeft;
+				}
 			}
 		}
 
@@ -121,30 +122,70 @@ namespace Ogre
 
 		try
 		{
-			indexBuffer = vaoManager->createIndexBuffer( IndexBufferPacked::IT_16BIT,
-														 numIndices, BT_IMMUTABLE,
-														 indices, true );
+			indexBuffer = vaoManager->createIndexBuffer( IndexBufferPacked::IT_16BIT, numIndices,
+														 BT_IMMUTABLE, indices, false );
 		}
-		catch( Exception &e )
+		catch( Exception & )
 		{
-			OGRE_FREE_SIMD( indexBuffer, MEMCATEGORY_GEOMETRY );
-			indexBuffer = 0;
-			throw e;
+			OGRE_FREE_SIMD( indices, MEMCATEGORY_GEOMETRY );
+			throw;
 		}
 
+		OGRE_FREE_SIMD( indices, MEMCATEGORY_GEOMETRY );
+
 		return indexBuffer;
-	}*/
+	}
+	//-----------------------------------------------------------------------------------
+	IndexBufferPacked *ColibriOgreRenderable::createGlyphIndexBuffer( VaoManager *vaoManager )
+	{
+		// Vertices are expected to be layed out like this (see Label::addQuad):
+		//	0	3
+		//	1	2
+		using namespace Colibri;
+		const size_t numIndices = c_maxGlyphsPerDraw * c_numGlyphIndices;
+		uint16 *indices = reinterpret_cast<uint16 *>(
+			OGRE_MALLOC_SIMD( sizeof( uint16 ) * numIndices, MEMCATEGORY_GEOMETRY ) );
+		for( size_t i = 0u; i < c_maxGlyphsPerDraw; ++i )
+		{
+			const uint16 srcIdx = static_cast<uint16>( i * c_numGlyphVertices );
+			indices[i * c_numGlyphIndices + 0u] = srcIdx;
+			indices[i * c_numGlyphIndices + 1u] = static_cast<uint16>( srcIdx + 1u );
+			indices[i * c_numGlyphIndices + 2u] = static_cast<uint16>( srcIdx + 2u );
+
+			indices[i * c_numGlyphIndices + 3u] = static_cast<uint16>( srcIdx + 2u );
+			indices[i * c_numGlyphIndices + 4u] = static_cast<uint16>( srcIdx + 3u );
+			indices[i * c_numGlyphIndices + 5u] = srcIdx;
+		}
+
+		IndexBufferPacked *indexBuffer = 0;
+
+		try
+		{
+			indexBuffer = vaoManager->createIndexBuffer( IndexBufferPacked::IT_16BIT, numIndices,
+														 BT_IMMUTABLE, indices, false );
+		}
+		catch( Exception & )
+		{
+			OGRE_FREE_SIMD( indices, MEMCATEGORY_GEOMETRY );
+			throw;
+		}
+
+		OGRE_FREE_SIMD( indices, MEMCATEGORY_GEOMETRY );
+
+		return indexBuffer;
+	}
 	//-----------------------------------------------------------------------------------
 	VertexArrayObject *ColibriOgreRenderable::createVao( uint32 vertexCount, VaoManager *vaoManager,
-														 const bool bMultiPass )
+														 const bool bMultiPass,
+														 IndexBufferPacked *indexBuffer )
 	{
 		// Vertex declaration
 		VertexElement2Vec vertexElements;
 		vertexElements.reserve( 4 );
-		vertexElements.push_back( VertexElement2( VET_FLOAT2, VES_POSITION ) );
+		vertexElements.push_back( VertexElement2( c_positionVertexElementType, VES_POSITION ) );
 		vertexElements.push_back( VertexElement2( VET_USHORT2_NORM, VES_TEXTURE_COORDINATES ) );
 		vertexElements.push_back( VertexElement2( VET_UBYTE4_NORM, VES_DIFFUSE ) );
-		vertexElements.push_back( VertexElement2( VET_FLOAT4, VES_NORMAL ) );
+		vertexElements.push_back( VertexElement2( c_clipVertexElementType, VES_NORMAL ) );
 
 		// Create the actual vertex buffer.
 		Ogre::VertexBufferPacked *vertexBuffer = 0;
@@ -154,22 +195,23 @@ namespace Ogre
 		VertexBufferPackedVec vertexBuffers;
 		vertexBuffers.push_back( vertexBuffer );
 		Ogre::VertexArrayObject *vao =
-			vaoManager->createVertexArrayObject( vertexBuffers, 0, OT_TRIANGLE_LIST );
+			vaoManager->createVertexArrayObject( vertexBuffers, indexBuffer, OT_TRIANGLE_LIST );
 
 		return vao;
 	}
 	//-----------------------------------------------------------------------------------
 	VertexArrayObject *ColibriOgreRenderable::createTextVao( uint32 vertexCount, VaoManager *vaoManager,
-															 const bool bMultiPass )
+															 const bool bMultiPass,
+															 IndexBufferPacked *indexBuffer )
 	{
 		// Vertex declaration
 		VertexElement2Vec vertexElements;
 		vertexElements.reserve( 5 );
-		vertexElements.push_back( VertexElement2( VET_FLOAT2, VES_POSITION ) );
-		vertexElements.push_back( VertexElement2( VET_USHORT2, VES_BLEND_INDICES ) );
+		vertexElements.push_back( VertexElement2( c_positionVertexElementType, VES_POSITION ) );
+		vertexElements.push_back( VertexElement2( VET_USHORT4, VES_BLEND_INDICES ) );
 		vertexElements.push_back( VertexElement2( VET_UINT1, VES_TANGENT ) );
 		vertexElements.push_back( VertexElement2( VET_UBYTE4_NORM, VES_DIFFUSE ) );
-		vertexElements.push_back( VertexElement2( VET_FLOAT4, VES_NORMAL ) );
+		vertexElements.push_back( VertexElement2( c_clipVertexElementType, VES_NORMAL ) );
 
 		// Create the actual vertex buffer.
 		Ogre::VertexBufferPacked *vertexBuffer = 0;
@@ -180,7 +222,7 @@ namespace Ogre
 		VertexBufferPackedVec vertexBuffers;
 		vertexBuffers.push_back( vertexBuffer );
 		Ogre::VertexArrayObject *vao =
-			vaoManager->createVertexArrayObject( vertexBuffers, 0, OT_TRIANGLE_LIST );
+			vaoManager->createVertexArrayObject( vertexBuffers, indexBuffer, OT_TRIANGLE_LIST );
 
 		return vao;
 	}
@@ -120,6 +120,13 @@ namespace Ogre
 		}
 	}
 #endif
+	//-----------------------------------------------------------------------------------
+	static inline const char *toPieceStr( LwString &str, const ColourValue &colourValue )
+	{
+		str.clear();
+		str.a( colourValue.r, "f, ", colourValue.g, "f, " );
+		return str.a( colourValue.b, "f, ", colourValue.a, "f" ).c_str();
+	}
 	//-----------------------------------------------------------------------------------
 	const HlmsCache *HlmsColibri::createShaderCacheEntry(
 		uint32 renderableHash, const HlmsCache &passCache, uint32 finalHash,
@@ -142,23 +149,6 @@ namespace Ogre
 		return retVal;
 	}
 	//-----------------------------------------------------------------------------------
-	static inline const char *toPieceStr( LwString &str, const ColourValue &colourValue )
-	{
-		str.clear();
-		str.a( colourValue.r, "f, ", colourValue.g, "f, " );
-		return str.a( colourValue.b, "f, ", colourValue.a, "f" ).c_str();
-	}
-	static inline const char *toPieceStr( LwString &str, const Vector2 &value )
-	{
-		str.clear();
-		return str.a( value.x, "f, ", value.y, "f" ).c_str();
-	}
-	static inline const char *toPieceStr( LwString &str, const float value )
-	{
-		str.clear();
-		return str.a( value, "f" ).c_str();
-	}
-
 	void HlmsColibri::calculateHashForPreCreate( Renderable *renderable, PiecesMap *inOutPieces )
 	{
 		HlmsUnlit::calculateHashForPreCreate( renderable, inOutPieces );
@@ -191,7 +181,7 @@ namespace Ogre
 				setProperty( COLIBRI_NOTID "use_read_only_buffer", 1 );
 		}
 
-		// See Colibri::CustomShape
+		// See Colibri::CustomShape & Colibri::LabelBmp
 		if( customParams.find( 6374 ) != customParams.end() )
 		{
 			setProperty( COLIBRI_NOTID "colibri_custom_shape", 1 );
@@ -208,45 +198,34 @@ namespace Ogre
 
 			COLIBRI_ASSERT_HIGH( dynamic_cast<Colibri::GraphChart *>( renderable ) );
 			Colibri::GraphChart *graphChart = static_cast<Colibri::GraphChart *>( renderable );
-			const Colibri::GraphChart::Params &params = graphChart->getParams();
-
-			char tmpBuffer[128];
-			LwString pieceStr( LwString::FromEmptyPointer( tmpBuffer, sizeof( tmpBuffer ) ) );
-			pieceStr.clear();
-			inOutPieces[PixelShader]["colibri_graphStartTL"] =
-				toPieceStr( pieceStr, params.graphInnerTopLeft );
-			pieceStr.clear();
-			inOutPieces[PixelShader]["colibri_graphStartBR"] =
-				toPieceStr( pieceStr, params.graphInnerTopLeft + params.graphInnerSize );
-
-			const float intervalLength = 1.0f / float( params.numLines - 1u );
-			pieceStr.clear();
-			inOutPieces[PixelShader]["colibri_intervalLength"] = toPieceStr( pieceStr, intervalLength );
-
-			const float intervalBlankAreaSize = intervalLength - params.lineThickness;
-			pieceStr.clear();
-			inOutPieces[PixelShader]["colibri_intervalBlankAreaSize"] =
-				toPieceStr( pieceStr, Vector2( 0.0f, intervalBlankAreaSize ) );
-
-			inOutPieces[PixelShader]["colibri_lineColour"] = toPieceStr( pieceStr, params.lineColour );
-			inOutPieces[PixelShader]["colibri_bgInnerColour"] =
-				toPieceStr( pieceStr, params.bgInnerColour );
-			inOutPieces[PixelShader]["colibri_bgOuterColour"] =
-				toPieceStr( pieceStr, params.bgOuterColour );
 
+			// Everything else lives in the per-draw constants (see GraphChart::fillGraphDrawParams)
+			// so that all charts with a similar number of datasets share the same shader.
 			const std::vector<Colibri::GraphChart::Column> &columns = graphChart->getColumns();
 			const size_t numDatasets = columns.size();
-			setProperty(
-#if OGRE_VERSION >= OGRE_MAKE_VERSION( 4, 0, 0 )
-				kNoTid,
-#endif
-				"colibri_numDatasets", static_cast<int32>( numDatasets ) );
-			for( size_t i = 0u; i < numDatasets; ++i )
+			if( numDatasets <= Colibri::GraphChart::c_maxDatasets )
+			{
+				const int32 numDatasetsBucket =
+					static_cast<int32>( ( numDatasets + 3u ) & ~size_t( 3u ) );
+				setProperty( COLIBRI_NOTID "colibri_numDatasets", numDatasetsBucket );
+				setProperty( COLIBRI_NOTID "colibri_numDatasetVec4s", numDatasetsBucket / 4 );
+			}
+			else
 			{
-				pieceStr.clear();
-				IdString keyName( pieceStr.a( "colibri_datasetCol", (uint32)i ).c_str() );
-				inOutPieces[PixelShader][keyName] =
-					toPieceStr( pieceStr, columns[i].rectangle->getColour() );
+				// Too many datasets to send their colours through interpolants.
+				// Bake them into the shader instead (one shader per chart).
+				setProperty( COLIBRI_NOTID "colibri_numDatasets", static_cast<int32>( numDatasets ) );
+				setProperty( COLIBRI_NOTID "colibri_graph_baked_colours", 1 );
+
+				char tmpBuffer[128];
+				LwString pieceStr( LwString::FromEmptyPointer( tmpBuffer, sizeof( tmpBuffer ) ) );
+				for( size_t i = 0u; i < numDatasets; ++i )
+				{
+					pieceStr.clear();
+					IdString keyName( pieceStr.a( "colibri_datasetCol", (uint32)i ).c_str() );
+					inOutPieces[PixelShader][keyName] =
+						toPieceStr( pieceStr, columns[i].rectangle->getColour() );
+				}
 			}
 		}
 	}
@@ -279,6 +258,9 @@ namespace Ogre
 	uint32 HlmsColibri::fillBuffersForColibri( const HlmsCache *cache,
 											   const QueuedRenderable &queuedRenderable, bool casterPass,
 											   uint32 baseVertex, uint32 lastCacheHash,
+											   const float *drawParams,
+											   const uint32 *extraDrawParams,
+											   uint32 numExtraDrawParams,
 											   CommandBuffer *commandBuffer )
 	{
 		COLIBRI_ASSERT_HIGH( getProperty( cache->setProperties, HlmsBaseProp::GlobalClipPlanes ) == 0 &&
@@ -305,8 +287,8 @@ namespace Ogre
 
 			// layout(binding = 2) uniform InstanceBuffer {} instance
 			if( mCurrentConstBuffer < mConstBuffers.size() &&
-				(size_t)( ( mCurrentMappedConstBuffer - mStartMappedConstBuffer ) + 4 ) <=
-					mCurrentConstBufferSize )
+				(size_t)( ( mCurrentMappedConstBuffer - mStartMappedConstBuffer ) +
+						  4u * c_instanceEntriesPerWidget ) <= mCurrentConstBufferSize )
 			{
 				*commandBuffer->addCommand<CbShaderBuffer>() =
 					CbShaderBuffer( VertexShader, 2, mConstBuffers[mCurrentConstBuffer], 0, 0 );
@@ -367,8 +349,10 @@ namespace Ogre
 		uint32 *RESTRICT_ALIAS currentMappedConstBuffer = mCurrentMappedConstBuffer;
 		// float * RESTRICT_ALIAS currentMappedTexBuffer       = mCurrentMappedTexBuffer;
 
+		const uint32 numInstanceEntries = c_instanceEntriesPerWidget + numExtraDrawParams;
+
 		bool exceedsConstBuffer = (size_t)( ( currentMappedConstBuffer - mStartMappedConstBuffer ) +
-											4 ) > mCurrentConstBufferSize;
+											4u * numInstanceEntries ) > mCurrentConstBufferSize;
 
 		const size_t minimumTexBufferSize = 16;
 		bool exceedsTexBuffer = false /*(currentMappedTexBuffer - mStartMappedTexBuffer) +
@@ -400,6 +384,19 @@ namespace Ogre
 		*( currentMappedConstBuffer + 3 ) = baseVertex;
 		currentMappedConstBuffer += 4;
 
+		// float4 posOffset.xy clipScale.xy; float4 clipBias (see Colibri::DrawParams)
+		memcpy( currentMappedConstBuffer, drawParams,
+				sizeof( uint32 ) * 4u * ( c_instanceEntriesPerWidget - 1u ) );
+		currentMappedConstBuffer += 4u * ( c_instanceEntriesPerWidget - 1u );
+
+		if( numExtraDrawParams )
+		{
+			// See Colibri::Renderable::setExtraDrawParams
+			memcpy( currentMappedConstBuffer, extraDrawParams,
+					sizeof( uint32 ) * 4u * numExtraDrawParams );
+			currentMappedConstBuffer += 4u * numExtraDrawParams;
+		}
+
 		//---------------------------------------------------------------------------
 		//                          ---- PIXEL SHADER ----
 		//---------------------------------------------------------------------------
@@ -449,7 +446,8 @@ namespace Ogre
 		mCurrentMappedConstBuffer = currentMappedConstBuffer;
 		// mCurrentMappedTexBuffer     = currentMappedTexBuffer;
 
-		return uint32( ( ( mCurrentMappedConstBuffer - mStartMappedConstBuffer ) >> 2u ) - 1u );
+		return uint32( ( ( mCurrentMappedConstBuffer - mStartMappedConstBuffer ) >> 2u ) -
+					   numInstanceEntries );
 	}
 	//-----------------------------------------------------------------------------------
 	void HlmsColibri::getDefaultPaths( String &outDataFolderPath, StringVector &outLibraryFoldersPaths )
@@ -479,6 +477,19 @@ namespace Ogre
 													 const HlmsBlendblock *blendblock,
 													 const HlmsParamVec &paramVec )
 	{
-		return OGRE_NEW HlmsColibriDatablock( datablockName, this, macroblock, blendblock, paramVec );
+		HlmsDatablock *retVal =
+			OGRE_NEW HlmsColibriDatablock( datablockName, this, macroblock, blendblock, paramVec );
+
+		// The scissor rect comes from the pass (full viewport by default). OffScreenCanvas
+		// narrows it to only redraw the dirty region, which requires scissor testing.
+		// setMacroblock registers the copy with HlmsManager (our macroblock is already one).
+		if( !macroblock->mScissorTestEnabled )
+		{
+			HlmsMacroblock scissoredMacroblock = *macroblock;
+			scissoredMacroblock.mScissorTestEnabled = true;
+			retVal->setMacroblock( scissoredMacroblock );
+		}
+
+		return retVal;
 	}
 }  // namespace Ogre
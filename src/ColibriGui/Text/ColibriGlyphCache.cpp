@@ -0,0 +1,194 @@
+#include "ColibriGui/Text/ColibriGlyphCache.h"
+
+#include "ColibriGui/Text/ColibriShaperManager.h"
+
+#include <algorithm>
+
+namespace Colibri
+{
+	static const uint32_t c_emptyBucket = 0xFFFFFFFFu;
+	static const uint32_t c_glyphsPerBlock = 256u;
+	static const size_t c_initialNumBuckets = 64u;
+
+	GlyphCache::GlyphCache() : m_numSlots( 0u ), m_numGlyphs( 0u ) {}
+	//-------------------------------------------------------------------------
+	GlyphCache::~GlyphCache()
+	{
+		CachedGlyphPtrVec::const_iterator itor = m_blocks.begin();
+		CachedGlyphPtrVec::const_iterator endt = m_blocks.end();
+
+		while( itor != endt )
+			delete[] *itor++;
+		m_blocks.clear();
+	}
+	//-------------------------------------------------------------------------
+	uint32_t GlyphCache::calculateHash( uint32_t codepoint, uint32_t ptSize, uint32_t fontIdx )
+	{
+		// Combine the key, then apply MurmurHash3's finalizer so that
+		// the low bits (the ones we use) depend on all the bits of the key
+		uint32_t h = codepoint * 0x9E3779B1u;
+		h ^= ptSize * 0x85EBCA77u + ( h << 6u ) + ( h >> 2u );
+		h ^= fontIdx * 0xC2B2AE3Du + ( h << 6u ) + ( h >> 2u );
+		h ^= h >> 16u;
+		h *= 0x85EBCA6Bu;
+		h ^= h >> 13u;
+		h *= 0xC2B2AE35u;
+		h ^= h >> 16u;
+		return h;
+	}
+	//-------------------------------------------------------------------------
+	CachedGlyph *GlyphCache::getSlot( uint32_t slot ) const
+	{
+		COLIBRI_ASSERT_MEDIUM( slot < m_numSlots );
+		return &m_blocks[slot / c_glyphsPerBlock][slot % c_glyphsPerBlock];
+	}
+	//-------------------------------------------------------------------------
+	size_t GlyphCache::findBucket( uint32_t hash, uint32_t codepoint, uint32_t ptSize,
+								   uint32_t fontIdx ) const
+	{
+		const size_t mask = m_buckets.size() - 1u;
+		size_t idx = hash & mask;
+
+		while( true )
+		{
+			const Bucket &bucket = m_buckets[idx];
+			if( bucket.slot == c_emptyBucket )
+				return idx;
+
+			if( bucket.hash == hash )
+			{
+				const CachedGlyph *glyph = getSlot( bucket.slot );
+				if( glyph->codepoint == codepoint && glyph->ptSize == ptSize &&
+					glyph->font == fontIdx )
+				{
+					return idx;
+				}
+			}
+
+			idx = ( idx + 1u ) & mask;
+		}
+	}
+	//-------------------------------------------------------------------------
+	void GlyphCache::growBuckets()
+	{
+		BucketVec oldBuckets;
+		oldBuckets.swap( m_buckets );
+
+		Bucket emptyBucket;
+		emptyBucket.hash = 0u;
+		emptyBucket.slot = c_emptyBucket;
+		m_buckets.resize( std::max( oldBuckets.size() * 2u, c_initialNumBuckets ), emptyBucket );
+
+		const size_t mask = m_buckets.size() - 1u;
+
+		BucketVec::const_iterator itor = oldBuckets.begin();
+		BucketVec::const_iterator endt = oldBuckets.end();
+
+		while( itor != endt )
+		{
+			if( itor->slot != c_emptyBucket )
+			{
+				size_t idx = itor->hash & mask;
+				while( m_buckets[idx].slot != c_emptyBucket )
+					idx = ( idx + 1u ) & mask;
+				m_buckets[idx] = *itor;
+			}
+			++itor;
+		}
+	}
+	//-------------------------------------------------------------------------
+	CachedGlyph *colibri_nullable GlyphCache::find( uint32_t codepoint, uint32_t ptSize,
+													uint32_t fontIdx ) const
+	{
+		if( m_numGlyphs == 0u )
+			return 0;
+
+		const uint32_t hash = calculateHash( codepoint, ptSize, fontIdx );
+		const size_t idx = findBucket( hash, codepoint, ptSize, fontIdx );
+
+		const uint32_t slot = m_buckets[idx].slot;
+		if( slot == c_emptyBucket )
+			return 0;
+		return getSlot( slot );
+	}
+	//-------------------------------------------------------------------------
+	CachedGlyph *GlyphCache::insert( const CachedGlyph &glyph )
+	{
+		// Keep the load factor below 75%, otherwise probe sequences get too long
+		if( ( m_numGlyphs + 1u ) * 4u > m_buckets.size() * 3u )
+			growBuckets();
+
+		const uint32_t hash = calculateHash( glyph.codepoint, glyph.ptSize, glyph.font );
+		const size_t idx = findBucket( hash, glyph.codepoint, glyph.ptSize, glyph.font );
+
+		COLIBRI_ASSERT_LOW( m_buckets[idx].slot == c_emptyBucket &&
+							"Glyph is already in the cache!" );
+
+		uint32_t slot;
+		if( !m_freeSlots.empty() )
+		{
+			slot = m_freeSlots.back();
+			m_freeSlots.pop_back();
+		}
+		else
+		{
+			if( m_numSlots % c_glyphsPerBlock == 0u )
+				m_blocks.push_back( new CachedGlyph[c_glyphsPerBlock] );
+			slot = m_numSlots++;
+		}
+
+		m_buckets[idx].hash = hash;
+		m_buckets[idx].slot = slot;
+		++m_numGlyphs;
+
+		CachedGlyph *retVal = getSlot( slot );
+		*retVal = glyph;
+		return retVal;
+	}
+	//-------------------------------------------------------------------------
+	void GlyphCache::erase( CachedGlyph *glyph )
+	{
+		const uint32_t hash = calculateHash( glyph->codepoint, glyph->ptSize, glyph->font );
+		size_t idx = findBucket( hash, glyph->codepoint, glyph->ptSize, glyph->font );
+
+		COLIBRI_ASSERT_LOW( m_buckets[idx].slot != c_emptyBucket &&
+							getSlot( m_buckets[idx].slot ) == glyph &&
+							"Glyph is not in the cache. Use-after-free perhaps?" );
+
+		m_freeSlots.push_back( m_buckets[idx].slot );
+		--m_numGlyphs;
+
+		// Backward shift deletion: move back the entries after us that would no
+		// longer be reachable from their ideal bucket, so we don't need tombstones.
+		const size_t mask = m_buckets.size() - 1u;
+		size_t nextIdx = idx;
+		while( true )
+		{
+			nextIdx = ( nextIdx + 1u ) & mask;
+			const Bucket &nextBucket = m_buckets[nextIdx];
+			if( nextBucket.slot == c_emptyBucket )
+				break;
+
+			// Move it if its ideal bucket is not cyclically in ( idx; nextIdx ]
+			const size_t idealIdx = nextBucket.hash & mask;
+			const bool bReachable = idx <= nextIdx ? ( idx < idealIdx && idealIdx <= nextIdx )
+												   : ( idx < idealIdx || idealIdx <= nextIdx );
+			if( !bReachable )
+			{
+				m_buckets[idx] = nextBucket;
+				idx = nextIdx;
+			}
+		}
+
+		m_buckets[idx].hash = 0u;
+		m_buckets[idx].slot = c_emptyBucket;
+	}
+	//-------------------------------------------------------------------------
+	CachedGlyph *colibri_nullable GlyphCache::getGlyphAtBucket( size_t idx ) const
+	{
+		const uint32_t slot = m_buckets[idx].slot;
+		if( slot == c_emptyBucket )
+			return 0;
+		return getSlot( slot );
+	}
+}  // namespace Colibri
@@ -0,0 +1,206 @@
+#include "ColibriGui/Text/ColibriGlyphRasterizer.h"
+
+#include "ft2build.h"
+
+#include "freetype/freetype.h"
+
+#include <algorithm>
+#include <string.h>
+#include <utility>
+
+namespace Colibri
+{
+	/// A font opened by a worker thread
+	struct WorkerFace
+	{
+		FT_Face  face;
+		uint32_t ptSize;
+		uint32_t dpi;
+	};
+
+	typedef std::vector<WorkerFace> WorkerFaceVec;
+
+	static FT_Face colibri_nullable getWorkerFace( FT_Library library, WorkerFaceVec &faces,
+												   const GlyphRasterizer::Request &request )
+	{
+		if( request.font >= faces.size() )
+		{
+			WorkerFace emptyFace;
+			emptyFace.face = 0;
+			emptyFace.ptSize = 0u;
+			emptyFace.dpi = 0u;
+			faces.resize( request.font + 1u, emptyFace );
+		}
+
+		WorkerFace &workerFace = faces[request.font];
+		if( !workerFace.face )
+		{
+			if( FT_New_Face( library, request.fontPath, 0, &workerFace.face ) )
+				workerFace.face = 0;
+		}
+
+		if( workerFace.face &&
+			( workerFace.ptSize != request.ptSize || workerFace.dpi != request.dpi ) )
+		{
+			FT_Set_Char_Size( workerFace.face, 0, (FT_F26Dot6)request.ptSize, request.dpi,
+							  request.dpi );
+			workerFace.ptSize = request.ptSize;
+			workerFace.dpi = request.dpi;
+		}
+
+		return workerFace.face;
+	}
+	//-------------------------------------------------------------------------
+	/// Renders the glyph and places it inside the box reserved by the request.
+	/// On failure the glyph is left blank.
+	static void rasterizeGlyph( FT_Library colibri_nullable library, WorkerFaceVec &faces,
+								const GlyphRasterizer::Request &request,
+								GlyphRasterizer::Result &outResult )
+	{
+		outResult.codepoint = request.codepoint;
+		outResult.ptSize = request.ptSize;
+		outResult.font = request.font;
+		outResult.width = request.width;
+		outResult.height = request.height;
+		outResult.pixels.clear();
+		outResult.pixels.resize( size_t( request.width ) * request.height, 0u );
+
+		if( !library )
+			return;
+
+		FT_Face face = getWorkerFace( library, faces, request );
+		if( !face || FT_Load_Glyph( face, request.glyphIndex, FT_LOAD_DEFAULT ) ||
+			FT_Render_Glyph( face->glyph, FT_RENDER_MODE_NORMAL ) )
+		{
+			return;
+		}
+
+		// The box was calculated by the main thread from the glyph's outline. Both should
+		// match, but we don't rely on it: a mismatch would only crop the edges.
+		const FT_GlyphSlot slot = face->glyph;
+		const FT_Bitmap &bitmap = slot->bitmap;
+		const int32_t offsetX = slot->bitmap_left - request.left;
+		const int32_t offsetY = request.top - slot->bitmap_top;
+
+		const int32_t srcStartX = std::max( -offsetX, 0 );
+		const int32_t srcEndX =
+			std::min( static_cast<int32_t>( bitmap.width ), int32_t( request.width ) - offsetX );
+		const int32_t srcStartY = std::max( -offsetY, 0 );
+		const int32_t srcEndY =
+			std::min( static_cast<int32_t>( bitmap.rows ), int32_t( request.height ) - offsetY );
+
+		if( srcStartX >= srcEndX )
+			return;
+
+		for( int32_t y = srcStartY; y < srcEndY; ++y )
+		{
+			const uint8_t *srcRow = bitmap.buffer + static_cast<ptrdiff_t>( y ) * bitmap.pitch;
+			uint8_t *dstRow =
+				&outResult.pixels[size_t( y + offsetY ) * request.width + size_t( srcStartX + offsetX )];
+			memcpy( dstRow, srcRow + srcStartX, size_t( srcEndX - srcStartX ) );
+		}
+	}
+	//-------------------------------------------------------------------------
+	GlyphRasterizer::GlyphRasterizer( uint32_t numThreads ) : m_numInFlight( 0u ), m_bExit( false )
+	{
+		COLIBRI_ASSERT_LOW( numThreads > 0u );
+
+		m_threads.reserve( numThreads );
+		for( uint32_t i = 0u; i < numThreads; ++i )
+			m_threads.push_back( std::thread( &GlyphRasterizer::workerThread, this ) );
+	}
+	//-------------------------------------------------------------------------
+	GlyphRasterizer::~GlyphRasterizer()
+	{
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_bExit = true;
+			m_numInFlight -= m_requests.size();
+			m_requests.clear();
+		}
+		m_workAvailable.notify_all();
+
+		std::vector<std::thread>::iterator itor = m_threads.begin();
+		std::vector<std::thread>::iterator endt = m_threads.end();
+
+		while( itor != endt )
+		{
+			itor->join();
+			++itor;
+		}
+		m_threads.clear();
+	}
+	//-------------------------------------------------------------------------
+	void GlyphRasterizer::workerThread()
+	{
+		FT_Library library = 0;
+		if( FT_Init_FreeType( &library ) )
+			library = 0;
+
+		WorkerFaceVec faces;
+		Result result;
+
+		std::unique_lock<std::mutex> lock( m_mutex );
+
+		while( true )
+		{
+			while( !m_bExit && m_requests.empty() )
+				m_workAvailable.wait( lock );
+
+			if( m_bExit )
+				break;
+
+			const Request request = m_requests.front();
+			m_requests.pop_front();
+
+			lock.unlock();
+			rasterizeGlyph( library, faces, request, result );
+			lock.lock();
+
+			m_results.push_back( std::move( result ) );
+
+			--m_numInFlight;
+			if( m_numInFlight == 0u )
+				m_workDone.notify_all();
+		}
+
+		lock.unlock();
+
+		WorkerFaceVec::const_iterator itor = faces.begin();
+		WorkerFaceVec::const_iterator endt = faces.end();
+
+		while( itor != endt )
+		{
+			if( itor->face )
+				FT_Done_Face( itor->face );
+			++itor;
+		}
+
+		if( library )
+			FT_Done_FreeType( library );
+	}
+	//-------------------------------------------------------------------------
+	void GlyphRasterizer::queue( const Request &request )
+	{
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_requests.push_back( request );
+			++m_numInFlight;
+		}
+		m_workAvailable.notify_one();
+	}
+	//-------------------------------------------------------------------------
+	void GlyphRasterizer::fetchResults( ResultVec &outResults )
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		outResults.swap( m_results );
+		m_results.clear();
+	}
+	//-------------------------------------------------------------------------
+	void GlyphRasterizer::finishPendingWork()
+	{
+		std::unique_lock<std::mutex> lock( m_mutex );
+		while( m_numInFlight > 0u )
+			m_workDone.wait( lock );
+	}
+}  // namespace Colibri
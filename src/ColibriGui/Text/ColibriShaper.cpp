@@ -66,7 +66,8 @@ namespace Colibri
 		m_ptSize( 0u ),
 		m_fontIdx(
 			std::max<uint16_t>( static_cast<uint16_t>( shaperManager->getShapers().size() ), 1u ) ),
-		m_useCodepoint0ForRaster( false )
+		m_useCodepoint0ForRaster( false ),
+		m_fontLocation( fontLocation )
 	{
 #ifndef __ANDROID__
 		FT_Error errorCode = FT_New_Face( m_library, fontLocation, 0, &m_ftFont );
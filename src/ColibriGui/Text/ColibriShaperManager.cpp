@@ -3,6 +3,7 @@
 
 #include "ColibriGui/ColibriManager.h"
 #include "ColibriGui/Text/ColibriBmpFont.h"
+#include "ColibriGui/Text/ColibriGlyphRasterizer.h"
 #include "ColibriGui/Text/ColibriShaper.h"
 
 #include "ColibriGui/Ogre/OgreHlmsColibri.h"
@@ -10,6 +11,7 @@
 #if OGRE_VERSION >= OGRE_MAKE_VERSION( 2, 3, 0 )
 #	include "Vao/OgreReadOnlyBufferPacked.h"
 #endif
+#include "Vao/OgreStagingBuffer.h"
 #include "Vao/OgreTexBufferPacked.h"
 #include "Vao/OgreVaoManager.h"
 
@@ -18,12 +20,22 @@
 #include "ft2build.h"
 
 #include "freetype/freetype.h"
+#include "freetype/ftoutln.h"
 
 #include "unicode/ubidi.h"
 #include "unicode/unistr.h"
 
+#include <algorithm>
+
 namespace Colibri
 {
+	/// Dirty ranges this close to each other are uploaded as a single transfer.
+	/// Uploading a few unchanged bytes is cheaper than issuing another copy.
+	static const size_t c_dirtyRangeMergeGap = 1024u;
+	/// How many of the coldest glyphs of the same size class findGlyphToEvict
+	/// looks at. Keeps eviction O(1) while avoiding most flushes.
+	static const size_t c_maxSameClassEvictionScan = 8u;
+
 	// PUA: Private User Area.
 	// Unicode defines them as strong LTR. But since we're treating them more like emojis,
 	// they need to be weaker. We should be using U_OTHER_NEUTRAL on PUA, but for some reason
@@ -42,6 +54,11 @@ namespace Colibri
 	ShaperManager::ShaperManager( ColibriManager *colibriManager ) :
 		m_ftLibrary( 0 ),
 		m_colibriManager( colibriManager ),
+		m_numUnusedGlyphs( 0u ),
+		m_numCacheHits( 0u ),
+		m_numCacheMisses( 0u ),
+		m_numEvictions( 0u ),
+		m_rasterizedGlyphsGeneration( 0u ),
 		m_glyphAtlas( 0 ),
 		m_offsetPtr( 1 ),  // The 1st byte is taken. See ShaperManager::updateGpuBuffers
 		m_atlasCapacity( 0 ),
@@ -53,7 +70,8 @@ namespace Colibri
 		m_dpi( 96u ),
 		m_glyphAtlasBuffer( 0 ),
 		m_hlms( 0 ),
-		m_vaoManager( 0 )
+		m_vaoManager( 0 ),
+		m_glyphRasterizer( 0 )
 	{
 		FT_Error errorCode = FT_Init_FreeType( &m_ftLibrary );
 		if( errorCode )
@@ -77,6 +95,10 @@ namespace Colibri
 	//-------------------------------------------------------------------------
 	ShaperManager::~ShaperManager()
 	{
+		// Workers use the fonts of our shapers
+		delete m_glyphRasterizer;
+		m_glyphRasterizer = 0;
+
 		if( !m_shapers.empty() )
 		{
 			ShaperVec::const_iterator itor = m_shapers.begin() + 1u;
@@ -119,18 +141,7 @@ namespace Colibri
 			m_hlms->setGlyphAtlasBuffer( 0 );
 		if( m_vaoManager && m_glyphAtlasBuffer )
 		{
-#if OGRE_VERSION >= OGRE_MAKE_VERSION( 2, 3, 0 )
-			if( m_glyphAtlasBuffer->getBufferPackedType() != Ogre::BP_TYPE_TEX )
-			{
-				m_vaoManager->destroyReadOnlyBuffer(
-					static_cast<Ogre::ReadOnlyBufferPacked *>( m_glyphAtlasBuffer ) );
-			}
-			else
-#endif
-			{
-				m_vaoManager->destroyTexBuffer(
-					static_cast<Ogre::TexBufferPacked *>( m_glyphAtlasBuffer ) );
-			}
+			destroyGpuBuffer( m_glyphAtlasBuffer );
 			m_glyphAtlasBuffer = 0;
 		}
 
@@ -167,6 +178,71 @@ namespace Colibri
 		log->log( msg.c_str(), LogSeverity::Info );
 	}
 	//-------------------------------------------------------------------------
+	void ShaperManager::setAsyncRasterization( uint32_t numThreads )
+	{
+		if( m_glyphRasterizer )
+		{
+			// Don't leave glyphs without pixels
+			// Every ColibriManager redraws its Labels on its next update.
+			// See getRasterizedGlyphsGeneration
+			m_glyphRasterizer->finishPendingWork();
+			processRasterizedGlyphs();
+
+			delete m_glyphRasterizer;
+			m_glyphRasterizer = 0;
+		}
+
+#ifndef __ANDROID__
+		if( numThreads > 0u )
+			m_glyphRasterizer = new GlyphRasterizer( numThreads );
+#else
+		if( numThreads > 0u )
+		{
+			getLogListener()->log( "ShaperManager::setAsyncRasterization is not supported on Android",
+								   LogSeverity::Warning );
+		}
+#endif
+	}
+	//-------------------------------------------------------------------------
+	uint32_t ShaperManager::getAsyncRasterizationThreads() const
+	{
+		return m_glyphRasterizer ? static_cast<uint32_t>( m_glyphRasterizer->getNumThreads() ) : 0u;
+	}
+	//-------------------------------------------------------------------------
+	bool ShaperManager::processRasterizedGlyphs()
+	{
+		if( !m_glyphRasterizer )
+			return false;
+
+		GlyphRasterizer::ResultVec results;
+		m_glyphRasterizer->fetchResults( results );
+
+		bool bAnyGlyphReady = false;
+
+		GlyphRasterizer::ResultVec::const_iterator itor = results.begin();
+		GlyphRasterizer::ResultVec::const_iterator endt = results.end();
+
+		while( itor != endt )
+		{
+			// The glyph may have been evicted while the worker was busy (and maybe
+			// cached again, in which case the results are just as valid).
+			CachedGlyph *glyph = m_glyphCache.find( itor->codepoint, itor->ptSize, itor->font );
+			if( glyph && glyph->pendingRaster )
+			{
+				COLIBRI_ASSERT_MEDIUM( glyph->width == itor->width && glyph->height == itor->height );
+				copyToAtlas( *glyph, &itor->pixels[0], itor->width );
+				glyph->pendingRaster = false;
+				bAnyGlyphReady = true;
+			}
+			++itor;
+		}
+
+		if( bAnyGlyphReady )
+			++m_rasterizedGlyphsGeneration;
+
+		return bAnyGlyphReady;
+	}
+	//-------------------------------------------------------------------------
 	Shaper* ShaperManager::addShaper( uint32_t /*hb_script_t*/ script, const char *fontPath,
 									  const std::string &language )
 	{
@@ -227,6 +303,37 @@ namespace Colibri
 		m_glyphAtlas = reinterpret_cast<uint8_t*>( realloc( m_glyphAtlas, m_atlasCapacity ) );
 	}
 	//-------------------------------------------------------------------------
+	void ShaperManager::copyToAtlas( const CachedGlyph &glyph, const uint8_t *srcData, int srcPitch )
+	{
+		// Glyphs are tightly packed in the atlas, thus their row pitch is their width
+		const size_t dstPitch = glyph.width;
+
+		Range dirtyRange;
+		dirtyRange.offset = glyph.offsetStart;
+		dirtyRange.size = glyph.getSizeBytes();
+
+		uint8_t *dstData = m_glyphAtlas + glyph.offsetStart;
+		if( !srcData )
+		{
+			memset( dstData, 0, dirtyRange.size );
+		}
+		else if( srcPitch == static_cast<int>( dstPitch ) )
+		{
+			memcpy( dstData, srcData, dirtyRange.size );
+		}
+		else
+		{
+			for( size_t y = 0u; y < glyph.height; ++y )
+			{
+				memcpy( dstData + y * dstPitch, srcData + static_cast<ptrdiff_t>( y ) * srcPitch,
+						glyph.width );
+			}
+		}
+
+		//Schedule a transfer to the GPU.
+		m_dirtyRanges.push_back( dirtyRange );
+	}
+	//-------------------------------------------------------------------------
 	size_t ShaperManager::getAtlasOffset( size_t sizeBytes )
 	{
 		//Get smallest available free range
@@ -237,7 +344,7 @@ namespace Colibri
 			RangeVec::iterator itor = m_freeRanges.begin();
 			while( itor != end )
 			{
-				if( sizeBytes < itor->size && (bestRange == end || bestRange->size > itor->size) )
+				if( sizeBytes <= itor->size && (bestRange == end || bestRange->size > itor->size) )
 					bestRange = itor;
 				++itor;
 			}
@@ -259,43 +366,29 @@ namespace Colibri
 			if( m_offsetPtr + sizeBytes > m_atlasCapacity )
 			{
 				//We're out of space. First check if we can steal another slot.
-				const CachedGlyphMap::iterator enGlyph = m_glyphCache.end();
-				CachedGlyphMap::iterator bestUnusedGlyph = enGlyph;
+				CachedGlyph *unusedGlyph = findGlyphToEvict( sizeBytes );
 
-				for( size_t i = 0; i < 2u && bestUnusedGlyph == enGlyph; ++i )
+				if( unusedGlyph )
 				{
-					CachedGlyphMap::iterator itGlyph = m_glyphCache.begin();
-					while( itGlyph != enGlyph )
-					{
-						if( !itGlyph->second.refCount && itGlyph->second.getSizeBytes() >= sizeBytes &&
-							( bestUnusedGlyph == enGlyph ||
-							  itGlyph->second.getSizeBytes() < bestUnusedGlyph->second.getSizeBytes() ) )
-						{
-							bestUnusedGlyph = itGlyph;
-						}
-						++itGlyph;
-					}
-
-					// Not found? Try again, this time with all unused glyphs removed and merged.
-					// We may have two contiguous unused glyphs that are big enough to hold
+					//Steal successful! Put the unused glyph back into the pool and try again
+					destroyGlyph( unusedGlyph );
+					retVal = getAtlasOffset( sizeBytes );
+				}
+				else if( m_numUnusedGlyphs > 0u )
+				{
+					// The unused glyphs are all too small. Remove them all and try again:
+					// we may have contiguous unused glyphs that are big enough to hold
 					// this new glyph, but weren't big enough individually.
-					if( i == 0 && bestUnusedGlyph == enGlyph )
-						flushReleasedGlyphs();
+					flushReleasedGlyphs();
+					retVal = getAtlasOffset( sizeBytes );
 				}
-
-				if( bestUnusedGlyph == enGlyph )
+				else
 				{
 					// Cannot steal. Grow the atlas, advance the pointer and get a fresh region
 					growAtlas( sizeBytes );
 					retVal = m_offsetPtr;
 					m_offsetPtr += sizeBytes;
 				}
-				else
-				{
-					//Steal successful! Put the unused glyph back into the pool and try again
-					destroyGlyph( bestUnusedGlyph );
-					retVal = getAtlasOffset( sizeBytes );
-				}
 			}
 			else
 			{
@@ -325,45 +418,83 @@ namespace Colibri
 			log->log( errorMsg.c_str(), LogSeverity::Warning );
 		}
 
-		//Rasterize the glyph
 		FT_GlyphSlot slot = font->glyph;
-		FT_Render_Glyph( slot, FT_RENDER_MODE_NORMAL );
-
-		FT_Bitmap ftBitmap = slot->bitmap;
 
 		//Create a cache entry
 		CachedGlyph newGlyph;
 		newGlyph.codepoint	= codepoint;
 		newGlyph.ptSize		= ptSize;
-		newGlyph.bearingX	= static_cast<float>( slot->bitmap_left );
-		newGlyph.bearingY	= static_cast<float>( slot->bitmap_top );
-		newGlyph.width		= static_cast<uint16_t>( ftBitmap.width );
-		newGlyph.height		= static_cast<uint16_t>( ftBitmap.rows );
+
+		const bool bAsync = m_glyphRasterizer && slot->format == FT_GLYPH_FORMAT_OUTLINE;
+
+		FT_Bitmap ftBitmap = slot->bitmap;
+		if( bAsync )
+		{
+			// A worker will rasterize it. Calculate the size of the bitmap
+			// the same way FT_Render_Glyph does: grid fit the control box.
+			FT_BBox cbox;
+			FT_Outline_Get_CBox( &slot->outline, &cbox );
+			const FT_Pos left = cbox.xMin & ~63;
+			const FT_Pos bottom = cbox.yMin & ~63;
+			const FT_Pos right = ( cbox.xMax + 63 ) & ~63;
+			const FT_Pos top = ( cbox.yMax + 63 ) & ~63;
+
+			newGlyph.bearingX	= static_cast<float>( left >> 6 );
+			newGlyph.bearingY	= static_cast<float>( top >> 6 );
+			newGlyph.width		= static_cast<uint16_t>( ( right - left ) >> 6 );
+			newGlyph.height		= static_cast<uint16_t>( ( top - bottom ) >> 6 );
+		}
+		else
+		{
+			//Rasterize the glyph
+			FT_Render_Glyph( slot, FT_RENDER_MODE_NORMAL );
+
+			ftBitmap = slot->bitmap;
+
+			newGlyph.bearingX	= static_cast<float>( slot->bitmap_left );
+			newGlyph.bearingY	= static_cast<float>( slot->bitmap_top );
+			newGlyph.width		= static_cast<uint16_t>( ftBitmap.width );
+			newGlyph.height		= static_cast<uint16_t>( ftBitmap.rows );
+		}
 		newGlyph.offsetStart = (uint32_t)getAtlasOffset( newGlyph.getSizeBytes() );
 		newGlyph.newlineSize = (float)font->size->metrics.height / 64.0f;
 		newGlyph.regionUp = (float)font->size->metrics.ascender /
 							float( font->size->metrics.ascender - font->size->metrics.descender );
 		newGlyph.font = fontIdx;
 		newGlyph.refCount	= 0;
+		newGlyph.lruPrev	= 0;
+		newGlyph.lruNext	= 0;
+		newGlyph.pendingRaster = bAsync && newGlyph.getSizeBytes() > 0u;
 
-		const GlyphKey glyphKey( codepoint, ptSize, fontIdx );
-		std::pair<CachedGlyphMap::iterator, bool> pair =
-				m_glyphCache.emplace( glyphKey, newGlyph );
+		CachedGlyph *retVal = m_glyphCache.insert( newGlyph );
 
-		if( newGlyph.getSizeBytes() > 0 )
+		if( newGlyph.pendingRaster )
+		{
+			// Leave it blank until the worker is done
+			copyToAtlas( newGlyph, 0, 0 );
+
+			COLIBRI_ASSERT_MEDIUM( fontIdx < m_shapers.size() );
+
+			GlyphRasterizer::Request request;
+			request.codepoint = newGlyph.codepoint;
+			request.glyphIndex = bDummy ? 0u : codepoint;
+			request.ptSize = ptSize;
+			request.font = fontIdx;
+			request.dpi = m_dpi;
+			request.fontPath = m_shapers[fontIdx]->getFontLocation().c_str();
+			request.left = static_cast<int32_t>( newGlyph.bearingX );
+			request.top = static_cast<int32_t>( newGlyph.bearingY );
+			request.width = newGlyph.width;
+			request.height = newGlyph.height;
+			m_glyphRasterizer->queue( request );
+		}
+		else if( newGlyph.getSizeBytes() > 0 )
 		{
 			//Copy the rasterized results to our atlas
-			memcpy( m_glyphAtlas + newGlyph.offsetStart, ftBitmap.buffer, newGlyph.getSizeBytes() );
-			{
-				//Schedule a transfer to the GPU.
-				Range dirtyRange;
-				dirtyRange.offset	= newGlyph.offsetStart;
-				dirtyRange.size		= newGlyph.getSizeBytes();
-				m_dirtyRanges.push_back( dirtyRange );
-			}
+			copyToAtlas( newGlyph, ftBitmap.buffer, ftBitmap.pitch );
 		}
 
-		return &pair.first->second;
+		return retVal;
 	}
 	//-------------------------------------------------------------------------
 	CachedGlyph *ShaperManager::createRasterGlyph( FT_Face font, uint32_t codepoint, uint32_t ptSize,
@@ -407,35 +538,119 @@ namespace Colibri
 		newGlyph.regionUp	= 1.0f;  // Is this correct?
 		newGlyph.font		= fontIdx;
 		newGlyph.refCount	= 0;
+		newGlyph.lruPrev	= 0;
+		newGlyph.lruNext	= 0;
+		newGlyph.pendingRaster = false;
 
 		releaseGlyph( dummyCodepoint );
 
-		const GlyphKey glyphKey( codepoint, ptSize, fontIdx );
-		std::pair<CachedGlyphMap::iterator, bool> pair =
-				m_glyphCache.emplace( glyphKey, newGlyph );
-
-		return &pair.first->second;
+		return m_glyphCache.insert( newGlyph );
 	}
 	//-------------------------------------------------------------------------
-	void ShaperManager::destroyGlyph( CachedGlyphMap::iterator glyphIt )
+	void ShaperManager::destroyGlyph( CachedGlyph *glyph )
 	{
-		CachedGlyph &glyph = glyphIt->second;
+		COLIBRI_ASSERT_LOW( glyph->refCount == 0u && "Destroying a glyph that is still in use!" );
+
+		unlinkUnusedGlyph( glyph );
+		++m_numEvictions;
 
-		if( glyph.offsetStart + glyph.getSizeBytes() == m_offsetPtr )
+		if( glyph->offsetStart + glyph->getSizeBytes() == m_offsetPtr )
 		{
 			//Easy case. LIFO.
-			m_offsetPtr -= glyph.getSizeBytes();
+			m_offsetPtr -= glyph->getSizeBytes();
 		}
 		else
 		{
 			Range freeRange;
-			freeRange.offset= glyph.offsetStart;
-			freeRange.size	= glyph.getSizeBytes();
+			freeRange.offset= glyph->offsetStart;
+			freeRange.size	= glyph->getSizeBytes();
 			m_freeRanges.push_back( freeRange );
 			mergeContiguousBlocks( m_freeRanges.end() - 1u, m_freeRanges );
 		}
 
-		m_glyphCache.erase( glyphIt );
+		m_glyphCache.erase( glyph );
+	}
+	//-------------------------------------------------------------------------
+	size_t ShaperManager::getSizeClass( size_t sizeBytes )
+	{
+		if( sizeBytes == 0u )
+			return 0u;
+
+		size_t retVal = 1u;
+		while( ( size_t( 1u ) << ( retVal - 1u ) ) < sizeBytes )
+			++retVal;
+		return retVal;
+	}
+	//-------------------------------------------------------------------------
+	void ShaperManager::linkUnusedGlyph( CachedGlyph *glyph )
+	{
+		COLIBRI_ASSERT_MEDIUM( glyph->refCount == 0u && !glyph->lruPrev && !glyph->lruNext );
+
+		const size_t sizeClass = getSizeClass( glyph->getSizeBytes() );
+		if( sizeClass >= m_unusedGlyphs.size() )
+			m_unusedGlyphs.resize( sizeClass + 1u );
+
+		GlyphLruList &lruList = m_unusedGlyphs[sizeClass];
+		glyph->lruNext = lruList.head;
+		if( lruList.head )
+			lruList.head->lruPrev = glyph;
+		else
+			lruList.tail = glyph;
+		lruList.head = glyph;
+
+		++m_numUnusedGlyphs;
+	}
+	//-------------------------------------------------------------------------
+	void ShaperManager::unlinkUnusedGlyph( CachedGlyph *glyph )
+	{
+		COLIBRI_ASSERT_MEDIUM( glyph->refCount == 0u );
+
+		GlyphLruList &lruList =
+			m_unusedGlyphs[getSizeClass( glyph->getSizeBytes() )];
+
+		if( glyph->lruPrev )
+			glyph->lruPrev->lruNext = glyph->lruNext;
+		else
+			lruList.head = glyph->lruNext;
+
+		if( glyph->lruNext )
+			glyph->lruNext->lruPrev = glyph->lruPrev;
+		else
+			lruList.tail = glyph->lruPrev;
+
+		glyph->lruPrev = 0;
+		glyph->lruNext = 0;
+
+		COLIBRI_ASSERT_MEDIUM( m_numUnusedGlyphs > 0u );
+		--m_numUnusedGlyphs;
+	}
+	//-------------------------------------------------------------------------
+	CachedGlyph *colibri_nullable ShaperManager::findGlyphToEvict( size_t sizeBytes ) const
+	{
+		const size_t numClasses = m_unusedGlyphs.size();
+		const size_t sizeClass = getSizeClass( sizeBytes );
+
+		// Glyphs of our own class may be big enough too. Prefer them, to avoid
+		// evicting big glyphs for small ones, but only look at the coldest few.
+		if( sizeClass < numClasses )
+		{
+			CachedGlyph *glyph = m_unusedGlyphs[sizeClass].tail;
+			for( size_t i = 0u; glyph && i < c_maxSameClassEvictionScan; ++i )
+			{
+				if( glyph->getSizeBytes() >= sizeBytes )
+					return glyph;
+				glyph = glyph->lruPrev;
+			}
+		}
+
+		// Glyphs from the next class onwards are always big enough.
+		// Prefer the smallest class, for the same reason.
+		for( size_t i = sizeClass + 1u; i < numClasses; ++i )
+		{
+			if( m_unusedGlyphs[i].tail )
+				return m_unusedGlyphs[i].tail;
+		}
+		return 0;
 	}
 	//-------------------------------------------------------------------------
 	void ShaperManager::mergeContiguousBlocks( RangeVec::iterator blockToMerge,
@@ -489,17 +704,19 @@ namespace Colibri
 													uint16_t fontIdx, bool bDummy,
 													const bool bUseCodepoint0ForRaster )
 	{
-		CachedGlyph *retVal = 0;
+		COLIBRI_ASSERT_MEDIUM( fontIdx != 0 );
 
-		const GlyphKey glyphKey( codepoint, ptSize, fontIdx );
-		CachedGlyphMap::iterator itor = m_glyphCache.find( glyphKey );
+		CachedGlyph *retVal = m_glyphCache.find( codepoint, ptSize, fontIdx );
 
-		if( itor != m_glyphCache.end() )
+		if( retVal )
 		{
-			retVal = &itor->second;
+			++m_numCacheHits;
+			if( retVal->refCount == 0u )
+				unlinkUnusedGlyph( retVal );
 		}
 		else
 		{
+			++m_numCacheMisses;
 			if( !bDummy || !getDefaultBmpFontForRaster() )
 			{
 				retVal = createGlyph( font, codepoint, ptSize, fontIdx, bDummy );
@@ -518,59 +735,69 @@ namespace Colibri
 	//-------------------------------------------------------------------------
 	void ShaperManager::addRefCount( const CachedGlyph *cachedGlyph )
 	{
-		const GlyphKey glyphKey( cachedGlyph->codepoint, cachedGlyph->ptSize, cachedGlyph->font );
-
-		COLIBRI_ASSERT_MEDIUM( m_glyphCache.find( glyphKey ) != m_glyphCache.end() &&
+		COLIBRI_ASSERT_MEDIUM( m_glyphCache.find( cachedGlyph->codepoint, cachedGlyph->ptSize,
+												  cachedGlyph->font ) == cachedGlyph &&
 							   "Invalid glyph cache entry. Use-after-free perhaps?" );
 
 		CachedGlyph *nonConstCachedGlyph = const_cast<CachedGlyph*>( cachedGlyph );
+		if( nonConstCachedGlyph->refCount == 0u )
+			unlinkUnusedGlyph( nonConstCachedGlyph );
 		++nonConstCachedGlyph->refCount;
 	}
 	//-------------------------------------------------------------------------
 	void ShaperManager::releaseGlyph( uint32_t codepoint, uint32_t ptSize, uint16_t fontIdx )
 	{
-		const GlyphKey glyphKey( codepoint, ptSize, fontIdx );
+		COLIBRI_ASSERT_MEDIUM( fontIdx != 0 );
 
-		CachedGlyphMap::iterator itor = m_glyphCache.find( glyphKey );
+		CachedGlyph *glyph = m_glyphCache.find( codepoint, ptSize, fontIdx );
 
-		COLIBRI_ASSERT_LOW( itor != m_glyphCache.end() &&
-							"Invalid glyph cache entry not found. Use-after-free perhaps?" );
-		COLIBRI_ASSERT_LOW( itor->second.refCount > 0 );
+		COLIBRI_ASSERT_LOW( glyph && "Invalid glyph cache entry not found. Use-after-free perhaps?" );
+		COLIBRI_ASSERT_LOW( glyph->refCount > 0 );
 
-		if( itor != m_glyphCache.end() && itor->second.refCount > 0 )
-			--itor->second.refCount;
+		if( glyph && glyph->refCount > 0 )
+		{
+			--glyph->refCount;
+			if( glyph->refCount == 0u )
+				linkUnusedGlyph( glyph );
+		}
 	}
 	//-------------------------------------------------------------------------
 	void ShaperManager::releaseGlyph( const CachedGlyph *cachedGlyph )
 	{
-		const GlyphKey glyphKey( cachedGlyph->codepoint, cachedGlyph->ptSize, cachedGlyph->font );
-
-		COLIBRI_ASSERT_MEDIUM( m_glyphCache.find( glyphKey ) != m_glyphCache.end() &&
+		COLIBRI_ASSERT_MEDIUM( m_glyphCache.find( cachedGlyph->codepoint, cachedGlyph->ptSize,
+												  cachedGlyph->font ) == cachedGlyph &&
 							   "Invalid glyph cache entry. Use-after-free perhaps?" );
 		COLIBRI_ASSERT_LOW( cachedGlyph->refCount > 0 );
 
 		CachedGlyph *nonConstCachedGlyph = const_cast<CachedGlyph*>( cachedGlyph );
 		if( nonConstCachedGlyph->refCount > 0 )
+		{
 			--nonConstCachedGlyph->refCount;
+			if( nonConstCachedGlyph->refCount == 0u )
+				linkUnusedGlyph( nonConstCachedGlyph );
+		}
 	}
 	//-------------------------------------------------------------------------
 	void ShaperManager::flushReleasedGlyphs()
 	{
-		CachedGlyphMap::iterator itor = m_glyphCache.begin();
-		CachedGlyphMap::iterator end  = m_glyphCache.end();
+		GlyphLruListVec::iterator itor = m_unusedGlyphs.begin();
+		GlyphLruListVec::iterator endt = m_unusedGlyphs.end();
 
-		while( itor != end )
+		while( itor != endt )
 		{
-			if( !itor->second.refCount )
-			{
-				CachedGlyphMap::iterator toDelete = itor++;
-				destroyGlyph( toDelete );
-			}
-			else
-			{
-				++itor;
-			}
+			while( itor->tail )
+				destroyGlyph( itor->tail );
+			++itor;
 		}
+
+		COLIBRI_ASSERT_MEDIUM( m_numUnusedGlyphs == 0u );
+	}
+	//-------------------------------------------------------------------------
+	void ShaperManager::resetGlyphCacheStats()
+	{
+		m_numCacheHits = 0u;
+		m_numCacheMisses = 0u;
+		m_numEvictions = 0u;
 	}
 	//-------------------------------------------------------------------------
 	TextHorizAlignment::TextHorizAlignment ShaperManager::renderString(
@@ -698,21 +925,7 @@ namespace Colibri
 			m_atlasCapacity > 0u )
 		{
 			// Local buffer has changed (i.e. growAtlas was called). Realloc the GPU buffer.
-			if( m_glyphAtlasBuffer )
-			{
-#if OGRE_VERSION >= OGRE_MAKE_VERSION( 2, 3, 0 )
-				if( m_glyphAtlasBuffer->getBufferPackedType() != Ogre::BP_TYPE_TEX )
-				{
-					m_vaoManager->destroyReadOnlyBuffer(
-						static_cast<Ogre::ReadOnlyBufferPacked *>( m_glyphAtlasBuffer ) );
-				}
-				else
-#endif
-				{
-					m_vaoManager->destroyTexBuffer(
-						static_cast<Ogre::TexBufferPacked *>( m_glyphAtlasBuffer ) );
-				}
-			}
+			Ogre::BufferPacked *oldBuffer = m_glyphAtlasBuffer;
 
 #if OGRE_VERSION >= OGRE_MAKE_VERSION( 2, 3, 0 )
 			if( Ogre::HlmsColibri::needsReadOnlyBuffer( m_hlms->getRenderSystem()->getCapabilities(),
@@ -734,33 +947,129 @@ namespace Colibri
 			// It's mostly used for the background colour by Label.
 			m_glyphAtlas[0] = 0xff;
 
-			m_glyphAtlasBuffer->upload( m_glyphAtlas, 0, m_offsetPtr );
-			m_dirtyRanges.clear();
+			if( oldBuffer )
+			{
+				// Glyphs don't move when the atlas grows. Copy what the GPU already
+				// has instead of uploading it again, then upload what changed.
+				oldBuffer->copyTo( m_glyphAtlasBuffer, 0u, 0u,
+								   std::min( oldBuffer->getNumElements(), m_atlasCapacity ) );
+				destroyGpuBuffer( oldBuffer );
+				uploadDirtyRanges();
+			}
+			else
+			{
+				m_glyphAtlasBuffer->upload( m_glyphAtlas, 0, m_offsetPtr );
+				m_dirtyRanges.clear();
+			}
 		}
 		else
+		{
+			uploadDirtyRanges();
+		}
+	}
+	//-------------------------------------------------------------------------
+	void ShaperManager::destroyGpuBuffer( Ogre::BufferPacked *buffer )
+	{
+#if OGRE_VERSION >= OGRE_MAKE_VERSION( 2, 3, 0 )
+		if( buffer->getBufferPackedType() != Ogre::BP_TYPE_TEX )
+		{
+			m_vaoManager->destroyReadOnlyBuffer( static_cast<Ogre::ReadOnlyBufferPacked *>( buffer ) );
+		}
+		else
+#endif
+		{
+			m_vaoManager->destroyTexBuffer( static_cast<Ogre::TexBufferPacked *>( buffer ) );
+		}
+	}
+	//-------------------------------------------------------------------------
+	void ShaperManager::coalesceDirtyRanges()
+	{
+		if( m_dirtyRanges.empty() )
+			return;
+
+#ifdef OGRE_VK_WORKAROUND_PVR_ALIGNMENT
+		if( Ogre::Workarounds::mPowerVRAlignment )
+		{
+			RangeVec::iterator itor = m_dirtyRanges.begin();
+			RangeVec::iterator endt = m_dirtyRanges.end();
+
+			while( itor != endt )
+			{
+				const size_t newOffset =
+					Ogre::alignToPreviousMult( itor->offset, Ogre::Workarounds::mPowerVRAlignment );
+				itor->size += itor->offset - newOffset;
+				itor->offset = newOffset;
+				++itor;
+			}
+		}
+#endif
+
+		std::sort( m_dirtyRanges.begin(), m_dirtyRanges.end() );
+
+		// Merge in place. Ranges may overlap (e.g. a glyph cleared, then rasterized)
+		RangeVec::iterator merged = m_dirtyRanges.begin();
+		RangeVec::const_iterator itor = m_dirtyRanges.begin() + 1u;
+		RangeVec::const_iterator endt = m_dirtyRanges.end();
+
+		while( itor != endt )
+		{
+			if( itor->offset <= merged->offset + merged->size + c_dirtyRangeMergeGap )
+			{
+				merged->size = std::max( merged->size, itor->offset + itor->size - merged->offset );
+			}
+			else
+			{
+				++merged;
+				*merged = *itor;
+			}
+			++itor;
+		}
+
+		m_dirtyRanges.erase( merged + 1u, m_dirtyRanges.end() );
+	}
+	//-------------------------------------------------------------------------
+	void ShaperManager::uploadDirtyRanges()
+	{
+		coalesceDirtyRanges();
+
+		if( m_dirtyRanges.empty() )
+			return;
+
+		size_t totalBytes = 0u;
 		{
 			RangeVec::const_iterator itor = m_dirtyRanges.begin();
 			RangeVec::const_iterator endt = m_dirtyRanges.end();
 
 			while( itor != endt )
 			{
-				size_t offset = itor->offset;
-				size_t size = itor->size;
-#ifdef OGRE_VK_WORKAROUND_PVR_ALIGNMENT
-				if( Ogre::Workarounds::mPowerVRAlignment && offset > 0u )
-				{
-					const size_t newOffset =
-						Ogre::alignToPreviousMult( offset, Ogre::Workarounds::mPowerVRAlignment );
-					size += offset - newOffset;
-					offset = newOffset;
-				}
-#endif
-				m_glyphAtlasBuffer->upload( m_glyphAtlas + offset, offset, size );
+				totalBytes += itor->size;
 				++itor;
 			}
+		}
 
-			m_dirtyRanges.clear();
+		Ogre::StagingBuffer *stagingBuffer = m_vaoManager->getStagingBuffer( totalBytes, true );
+		uint8_t *stagingData = reinterpret_cast<uint8_t *>( stagingBuffer->map( totalBytes ) );
+
+		Ogre::StagingBuffer::DestinationVec destinations;
+		destinations.reserve( m_dirtyRanges.size() );
+
+		size_t srcOffset = 0u;
+		RangeVec::const_iterator itor = m_dirtyRanges.begin();
+		RangeVec::const_iterator endt = m_dirtyRanges.end();
+
+		while( itor != endt )
+		{
+			memcpy( stagingData + srcOffset, m_glyphAtlas + itor->offset, itor->size );
+			destinations.push_back( Ogre::StagingBuffer::Destination( m_glyphAtlasBuffer, itor->offset,
+																	  srcOffset, itor->size ) );
+			srcOffset += itor->size;
+			++itor;
 		}
+
+		stagingBuffer->unmap( destinations );
+		stagingBuffer->removeReferenceCount();
+
+		m_dirtyRanges.clear();
 	}
 	//-------------------------------------------------------------------------
 	void ShaperManager::prepareToRender() { m_hlms->setGlyphAtlasBuffer( m_glyphAtlasBuffer ); }